@@ -0,0 +1,226 @@
+/**
+ * Bitmap.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+
+#include "bitmap.h"
+
+using namespace DStarLite;
+
+/**
+ * @var  double  cost difference between bitmap and tile
+ */
+const double Bitmap::COST_DIFFERENCE = 255.0;
+
+/**
+ * @var  unsigned char  unwalkable value of bitmap
+ */
+const unsigned char Bitmap::UNWALKABLE_CELL = 0;
+
+/**
+ * Reads a little endian integer.
+ *
+ * @param   unsigned char*   bytes
+ * @param   unsigned int     number of bytes
+ * @return  unsigned int
+ */
+static unsigned int read_le(const unsigned char* p, unsigned int n)
+{
+	unsigned int v = 0;
+
+	for (unsigned int i = n; i-- > 0; )
+	{
+		v = (v << 8) | p[i];
+	}
+
+	return v;
+}
+
+/**
+ * Converts a gray value to a cell cost.
+ *
+ * @param   unsigned char   gray value
+ * @return  double          cost
+ */
+double Bitmap::cost(unsigned char v)
+{
+	if (v == Bitmap::UNWALKABLE_CELL)
+		return Map::Cell::COST_UNWALKABLE;
+
+	return Bitmap::COST_DIFFERENCE - v + 1.0;
+}
+
+/**
+ * Constructor.
+ */
+Bitmap::Bitmap()
+{
+	_w = 0;
+	_h = 0;
+}
+
+/**
+ * Gets the gray values, row by row from the top.
+ *
+ * @return  unsigned char*
+ */
+unsigned char* Bitmap::data()
+{
+	return _data.empty() ? NULL : &_data[0];
+}
+
+/**
+ * Gets the height.
+ *
+ * @return  unsigned int
+ */
+unsigned int Bitmap::h()
+{
+	return _h;
+}
+
+/**
+ * Loads a file.
+ *
+ * @param   char*   file name
+ * @return  bool    successful
+ */
+bool Bitmap::load(const char* file)
+{
+	FILE* fp = fopen(file, "rb");
+
+	if (fp == NULL)
+		return false;
+
+	unsigned char header[54];
+
+	if (fread(header, 1, sizeof(header), fp) != sizeof(header) || header[0] != 'B' || header[1] != 'M')
+	{
+		fclose(fp);
+		return false;
+	}
+
+	unsigned int offset = read_le(header + 10, 4);
+	unsigned int info = read_le(header + 14, 4);
+	int width = (int) read_le(header + 18, 4);
+	int height = (int) read_le(header + 22, 4);
+	unsigned int depth = read_le(header + 28, 2);
+	unsigned int compression = read_le(header + 30, 4);
+	unsigned int colors = read_le(header + 46, 4);
+
+	// Negative height is stored top down
+	bool top_down = (height < 0);
+
+	if (top_down)
+	{
+		height = -height;
+	}
+
+	if (width <= 0 || height == 0 || compression != 0 || (depth != 8 && depth != 24 && depth != 32))
+	{
+		fclose(fp);
+		return false;
+	}
+
+	// Palette (blue, green, red, reserved) follows the info header
+	unsigned char palette[256];
+
+	if (depth == 8)
+	{
+		if (colors == 0 || colors > 256)
+		{
+			colors = 256;
+		}
+
+		unsigned char entries[256 * 4];
+
+		if (fseek(fp, 14 + info, SEEK_SET) != 0 || fread(entries, 4, colors, fp) != colors)
+		{
+			fclose(fp);
+			return false;
+		}
+
+		for (unsigned int i = 0; i < 256; i++)
+		{
+			unsigned char* e = entries + ((i < colors) ? i : 0) * 4;
+			palette[i] = (unsigned char) (0.3 * e[2] + 0.59 * e[1] + 0.11 * e[0] + 0.5);
+		}
+	}
+
+	// Rows are padded to 4 bytes
+	unsigned int bytes = depth / 8;
+	unsigned int stride = (width * bytes + 3) & ~3u;
+	vector<unsigned char> row(stride);
+
+	_w = (unsigned int) width;
+	_h = (unsigned int) height;
+	_data.assign(_w * _h, 0);
+
+	if (fseek(fp, offset, SEEK_SET) != 0)
+	{
+		fclose(fp);
+		return false;
+	}
+
+	for (unsigned int i = 0; i < _h; i++)
+	{
+		if (fread(&row[0], 1, stride, fp) != stride)
+		{
+			fclose(fp);
+			return false;
+		}
+
+		unsigned char* out = &_data[(top_down ? i : _h - 1 - i) * _w];
+
+		for (unsigned int j = 0; j < _w; j++)
+		{
+			if (depth == 8)
+			{
+				out[j] = palette[row[j]];
+			}
+			else
+			{
+				// Blue, green, red
+				unsigned char* p = &row[j * bytes];
+				out[j] = (unsigned char) (0.3 * p[2] + 0.59 * p[1] + 0.11 * p[0] + 0.5);
+			}
+		}
+	}
+
+	fclose(fp);
+
+	return true;
+}
+
+/**
+ * Copies the costs into a map of the same size.
+ *
+ * @param   Map*   map
+ * @return  void
+ */
+void Bitmap::to_map(Map* map)
+{
+	for (unsigned int i = 0; i < _h; i++)
+	{
+		for (unsigned int j = 0; j < _w; j++)
+		{
+			map->cost((*map)(i, j), cost(_data[i * _w + j]));
+		}
+	}
+}
+
+/**
+ * Gets the width.
+ *
+ * @return  unsigned int
+ */
+unsigned int Bitmap::w()
+{
+	return _w;
+}
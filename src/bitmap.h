@@ -0,0 +1,111 @@
+/**
+ * Bitmap.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#ifndef DSTARLITE_BITMAP_H
+#define DSTARLITE_BITMAP_H
+
+#include <vector>
+
+#include "map.h"
+
+using namespace std;
+
+namespace DStarLite
+{
+	/**
+	 * Grayscale bitmap loader for the map files (no FLTK needed).
+	 *
+	 * Reads uncompressed 8-bit (paletted), 24-bit and 32-bit BMP files and
+	 * converts them to gray the same way the simulator does.
+	 */
+	class Bitmap
+	{
+		public:
+
+			/**
+			 * @var  static const double  cost difference between bitmap and tile
+			 */
+			static const double COST_DIFFERENCE;
+
+			/**
+			 * @var  static const unsigned char  unwalkable value of bitmap
+			 */
+			static const unsigned char UNWALKABLE_CELL;
+
+			/**
+			 * Converts a gray value to a cell cost.
+			 *
+			 * Black is unwalkable, white costs 1.
+			 *
+			 * @param   unsigned char   gray value
+			 * @return  double          cost
+			 */
+			static double cost(unsigned char v);
+
+			/**
+			 * Constructor.
+			 */
+			Bitmap();
+
+			/**
+			 * Gets the gray values, row by row from the top.
+			 *
+			 * @return  unsigned char*
+			 */
+			unsigned char* data();
+
+			/**
+			 * Gets the height.
+			 *
+			 * @return  unsigned int
+			 */
+			unsigned int h();
+
+			/**
+			 * Loads a file.
+			 *
+			 * @param   char*   file name
+			 * @return  bool    successful
+			 */
+			bool load(const char* file);
+
+			/**
+			 * Copies the costs into a map of the same size.
+			 *
+			 * @param   Map*   map
+			 * @return  void
+			 */
+			void to_map(Map* map);
+
+			/**
+			 * Gets the width.
+			 *
+			 * @return  unsigned int
+			 */
+			unsigned int w();
+
+		protected:
+
+			/**
+			 * @var  vector<unsigned char>  gray values
+			 */
+			vector<unsigned char> _data;
+
+			/**
+			 * @var  unsigned int  height
+			 */
+			unsigned int _h;
+
+			/**
+			 * @var  unsigned int  width
+			 */
+			unsigned int _w;
+	};
+};
+
+#endif // DSTARLITE_BITMAP_H
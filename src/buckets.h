@@ -0,0 +1,501 @@
+/**
+ * Buckets.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#ifndef DSTARLITE_BUCKETS_H
+#define DSTARLITE_BUCKETS_H
+
+#include <vector>
+
+#include "open_list.h"
+
+using namespace std;
+
+namespace DStarLite
+{
+	/**
+	 * Bucket queue over quantized keys.
+	 *
+	 * The first key component is quantized to an integer bucket
+	 * (floor(primary(k) / width), C must provide primary() in map cost units). Buckets above the cursor (the lowest bucket
+	 * that may hold cells) are intrusive lists in a shared node pool, so
+	 * inserting or removing there is O(1). Only the cursor bucket is kept
+	 * ordered, in a small binary heap, which keeps the exact key compare order
+	 * even though many cells share the same first key component.
+	 *
+	 * Keys may go down as well as up (D* Lite re-inserts below the last popped
+	 * key after the start moves), which only moves the cursor back.
+	 */
+	template <typename K, typename C>
+	class Buckets : public OpenList<K,C>
+	{
+		public:
+
+			/**
+			 * @var  static const unsigned int  highest bucket (larger keys share it)
+			 */
+			static const unsigned int MAX_BUCKET = (1 << 24) - 1;
+
+			/**
+			 * Constructor.
+			 *
+			 * @param  double   bucket width in key units
+			 */
+			Buckets(double width)
+			{
+				_scale = 1.0 / width;
+				_cursor = 0;
+				_free = OpenList<K,C>::NONE;
+				_size = 0;
+			}
+
+			/**
+			 * Removes all cells from the list.
+			 *
+			 * @return  void
+			 */
+			void clear()
+			{
+				for (unsigned int i = 0; i < _nodes.size(); i++)
+				{
+					if (_nodes[i].pos != NULL)
+					{
+						*_nodes[i].pos = OpenList<K,C>::NONE;
+					}
+				}
+
+				_nodes.clear();
+				_active.clear();
+				_heads.assign(_heads.size(), OpenList<K,C>::NONE);
+				_cursor = 0;
+				_free = OpenList<K,C>::NONE;
+				_size = 0;
+			}
+
+			/**
+			 * Checks if the list is empty.
+			 *
+			 * @return  bool
+			 */
+			bool empty()
+			{
+				return _size == 0;
+			}
+
+			/**
+			 * Inserts a cell.
+			 *
+			 * @param   Map::Cell*       cell to insert
+			 * @param   K                key value for the cell
+			 * @param   unsigned int*    position of the cell
+			 * @return  void
+			 */
+			void insert(Map::Cell* u, K k, unsigned int* pos)
+			{
+				unsigned int n;
+
+				// Reuse a free node if possible
+				if (_free != OpenList<K,C>::NONE)
+				{
+					n = _free;
+					_free = _nodes[n].next;
+				}
+				else
+				{
+					n = (unsigned int) _nodes.size();
+					_nodes.push_back(Node());
+				}
+
+				Node* node = &_nodes[n];
+				node->key = k;
+				node->cell = u;
+				node->pos = pos;
+				*pos = n;
+
+				_place(n);
+				_size++;
+			}
+
+			/**
+			 * Removes a cell.
+			 *
+			 * @param   unsigned int*   position of the cell
+			 * @return  void
+			 */
+			void remove(unsigned int* pos)
+			{
+				unsigned int n = *pos;
+				*pos = OpenList<K,C>::NONE;
+
+				_take(n);
+				_size--;
+
+				// Put the node on the free list
+				_nodes[n].pos = NULL;
+				_nodes[n].next = _free;
+				_free = n;
+			}
+
+			/**
+			 * Gets the number of cells in the list.
+			 *
+			 * @return  unsigned int
+			 */
+			unsigned int size()
+			{
+				return _size;
+			}
+
+			/**
+			 * Gets the cell with the smallest key.
+			 *
+			 * @return  Map::Cell*
+			 */
+			Map::Cell* top()
+			{
+				return _nodes[_top()].cell;
+			}
+
+			/**
+			 * Gets the smallest key.
+			 *
+			 * @return  K
+			 */
+			K top_key()
+			{
+				return _nodes[_top()].key;
+			}
+
+			/**
+			 * Changes the key of a cell (either direction).
+			 *
+			 * @param   unsigned int*   position of the cell
+			 * @param   K               new key value
+			 * @return  void
+			 */
+			void update(unsigned int* pos, K k)
+			{
+				unsigned int n = *pos;
+				Node* node = &_nodes[n];
+
+				// Same bucket, only the cursor bucket has an order to fix
+				if (_bucket(k) == node->bucket)
+				{
+					bool decrease = _compare(k, node->key);
+					node->key = k;
+
+					if (node->slot != OpenList<K,C>::NONE)
+					{
+						if (decrease)
+						{
+							_up(node->slot, n);
+						}
+						else
+						{
+							_down(node->slot, n);
+						}
+					}
+
+					return;
+				}
+
+				_take(n);
+				_nodes[n].key = k;
+				_place(n);
+			}
+
+		protected:
+
+			/**
+			 * Bucket node.
+			 */
+			struct Node
+			{
+				K key;
+				Map::Cell* cell;
+				unsigned int* pos;
+				unsigned int bucket;
+				unsigned int next;
+				unsigned int prev;
+				unsigned int slot;
+			};
+
+			/**
+			 * @var  vector<unsigned int>  cursor bucket nodes in heap order
+			 */
+			vector<unsigned int> _active;
+
+			/**
+			 * @var  C  key compare
+			 */
+			C _compare;
+
+			/**
+			 * @var  unsigned int  lowest bucket that may hold cells
+			 */
+			unsigned int _cursor;
+
+			/**
+			 * @var  unsigned int  head of the free node list
+			 */
+			unsigned int _free;
+
+			/**
+			 * @var  vector<unsigned int>  first node of every bucket above the cursor
+			 */
+			vector<unsigned int> _heads;
+
+			/**
+			 * @var  vector<Node>  node pool
+			 */
+			vector<Node> _nodes;
+
+			/**
+			 * @var  double  buckets per key unit
+			 */
+			double _scale;
+
+			/**
+			 * @var  unsigned int  number of cells in the list
+			 */
+			unsigned int _size;
+
+			/**
+			 * Moves the cursor bucket back into its list.
+			 *
+			 * @return  void
+			 */
+			void _deactivate()
+			{
+				for (unsigned int i = 0; i < _active.size(); i++)
+				{
+					_link(_active[i]);
+				}
+
+				_active.clear();
+			}
+
+			/**
+			 * Quantizes a key.
+			 *
+			 * @param   K              key
+			 * @return  unsigned int   bucket
+			 */
+			unsigned int _bucket(const K& k)
+			{
+				double b = _compare.primary(k) * _scale;
+
+				if (b <= 0.0)
+					return 0;
+
+				return (b >= MAX_BUCKET) ? MAX_BUCKET : (unsigned int) b;
+			}
+
+			/**
+			 * Sifts a node down the cursor heap.
+			 *
+			 * @param   unsigned int   hole
+			 * @param   unsigned int   node to place
+			 * @return  void
+			 */
+			void _down(unsigned int i, unsigned int n)
+			{
+				unsigned int size = (unsigned int) _active.size();
+
+				while (true)
+				{
+					unsigned int min = i * 2 + 1;
+
+					if (min >= size)
+						break;
+
+					if (min + 1 < size && _compare(_nodes[_active[min + 1]].key, _nodes[_active[min]].key))
+					{
+						min++;
+					}
+
+					if ( ! _compare(_nodes[_active[min]].key, _nodes[n].key))
+						break;
+
+					_active[i] = _active[min];
+					_nodes[_active[i]].slot = i;
+					i = min;
+				}
+
+				_active[i] = n;
+				_nodes[n].slot = i;
+			}
+
+			/**
+			 * Adds a node to the front of its bucket list.
+			 *
+			 * @param   unsigned int   node
+			 * @return  void
+			 */
+			void _link(unsigned int n)
+			{
+				Node* node = &_nodes[n];
+				unsigned int b = node->bucket;
+
+				if (b >= _heads.size())
+				{
+					_heads.resize(b + 1, OpenList<K,C>::NONE);
+				}
+
+				node->slot = OpenList<K,C>::NONE;
+				node->prev = OpenList<K,C>::NONE;
+				node->next = _heads[b];
+
+				if (node->next != OpenList<K,C>::NONE)
+				{
+					_nodes[node->next].prev = n;
+				}
+
+				_heads[b] = n;
+			}
+
+			/**
+			 * Files a node under its bucket.
+			 *
+			 * @param   unsigned int   node
+			 * @return  void
+			 */
+			void _place(unsigned int n)
+			{
+				unsigned int b = _bucket(_nodes[n].key);
+				_nodes[n].bucket = b;
+
+				// New lowest bucket
+				if (_size == 0 || b < _cursor)
+				{
+					_deactivate();
+					_cursor = b;
+				}
+
+				if (b == _cursor)
+				{
+					_active.push_back(n);
+					_up((unsigned int) _active.size() - 1, n);
+				}
+				else
+				{
+					_link(n);
+				}
+			}
+
+			/**
+			 * Removes a node from its bucket.
+			 *
+			 * @param   unsigned int   node
+			 * @return  void
+			 */
+			void _take(unsigned int n)
+			{
+				Node* node = &_nodes[n];
+
+				// Cursor bucket, fill the hole with the last heap node
+				if (node->slot != OpenList<K,C>::NONE)
+				{
+					unsigned int i = node->slot;
+					unsigned int last = _active.back();
+					_active.pop_back();
+
+					if (last != n)
+					{
+						if (i > 0 && _compare(_nodes[last].key, _nodes[_active[(i - 1) / 2]].key))
+						{
+							_up(i, last);
+						}
+						else
+						{
+							_down(i, last);
+						}
+					}
+
+					return;
+				}
+
+				if (node->prev != OpenList<K,C>::NONE)
+				{
+					_nodes[node->prev].next = node->next;
+				}
+				else
+				{
+					_heads[node->bucket] = node->next;
+				}
+
+				if (node->next != OpenList<K,C>::NONE)
+				{
+					_nodes[node->next].prev = node->prev;
+				}
+			}
+
+			/**
+			 * Finds the minimum node.
+			 *
+			 * @return  unsigned int
+			 */
+			unsigned int _top()
+			{
+				if ( ! _active.empty())
+					return _active[0];
+
+				// Advance to the next bucket with cells and order it
+				do
+				{
+					_cursor++;
+				}
+				while (_heads[_cursor] == OpenList<K,C>::NONE);
+
+				for (unsigned int n = _heads[_cursor]; n != OpenList<K,C>::NONE; n = _nodes[n].next)
+				{
+					_active.push_back(n);
+				}
+
+				_heads[_cursor] = OpenList<K,C>::NONE;
+
+				for (unsigned int i = (unsigned int) _active.size() / 2; i-- > 0; )
+				{
+					_down(i, _active[i]);
+				}
+
+				for (unsigned int i = 0; i < _active.size(); i++)
+				{
+					_nodes[_active[i]].slot = i;
+				}
+
+				return _active[0];
+			}
+
+			/**
+			 * Sifts a node up the cursor heap.
+			 *
+			 * @param   unsigned int   hole
+			 * @param   unsigned int   node to place
+			 * @return  void
+			 */
+			void _up(unsigned int i, unsigned int n)
+			{
+				while (i > 0)
+				{
+					unsigned int parent = (i - 1) / 2;
+
+					if ( ! _compare(_nodes[n].key, _nodes[_active[parent]].key))
+						break;
+
+					_active[i] = _active[parent];
+					_nodes[_active[i]].slot = i;
+					i = parent;
+				}
+
+				_active[i] = n;
+				_nodes[n].slot = i;
+			}
+	};
+};
+
+#endif // DSTARLITE_BUCKETS_H
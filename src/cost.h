@@ -0,0 +1,314 @@
+/**
+ * Cost.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#ifndef DSTARLITE_COST_H
+#define DSTARLITE_COST_H
+
+#include <cfloat>
+#include <cmath>
+#include <stdint.h>
+#include <utility>
+
+#include "math.h"
+
+using namespace std;
+
+namespace DStarLite
+{
+	/**
+	 * 32-bit unsigned fixed point cost with 8 fractional bits.
+	 */
+	typedef uint32_t Fixed;
+
+	/**
+	 * Cost traits.
+	 *
+	 * Everything the planner does with g, rhs, km and keys goes through these,
+	 * so the same search runs on doubles (the reference), floats or fixed point.
+	 */
+	template <typename T>
+	class Cost;
+
+	/**
+	 * Double costs (reference implementation, epsilon compares).
+	 */
+	template <>
+	class Cost<double>
+	{
+		public:
+
+			/**
+			 * @var  typedef  key (pair of doubles)
+			 */
+			typedef pair<double,double> Key;
+
+			/**
+			 * @var  double  infinite cost
+			 */
+			static double inf() { return Math::INF; }
+
+			/**
+			 * Adds two costs.
+			 *
+			 * @param   double
+			 * @param   double
+			 * @return  double
+			 */
+			static double add(double a, double b) { return a + b; }
+
+			/**
+			 * Converts a lower bound (heuristic) in map cost units.
+			 *
+			 * Shaved a little, so a bound that is tight in exact arithmetic (a
+			 * straight run of equal moves) stays below the summed path cost after
+			 * rounding, and ties with the start key break the right way.
+			 *
+			 * @param   double   map cost
+			 * @return  double
+			 */
+			static double bound(double v) { return v * (1.0 - 1e-9); }
+
+			/**
+			 * Determines if two costs are equal.
+			 *
+			 * @param   double
+			 * @param   double
+			 * @return  bool
+			 */
+			static bool equals(double a, double b) { return Math::equals(a, b); }
+
+			/**
+			 * Converts a map cost.
+			 *
+			 * @param   double   map cost
+			 * @return  double
+			 */
+			static double from(double v) { return v; }
+
+			/**
+			 * Determines if a cost is greater than another.
+			 *
+			 * @param   double
+			 * @param   double
+			 * @return  bool
+			 */
+			static bool greater(double a, double b) { return Math::greater(a, b); }
+
+			/**
+			 * Calculates the octile heuristic.
+			 *
+			 * @param   unsigned int   smaller coordinate difference
+			 * @param   unsigned int   larger coordinate difference
+			 * @return  double
+			 */
+			static double octile(unsigned int min, unsigned int max) { return (Math::SQRT2 - 1.0) * min + max; }
+
+			/**
+			 * Builds a key.
+			 *
+			 * @param   double   first component
+			 * @param   double   second component
+			 * @return  Key
+			 */
+			static Key key(double k1, double k2) { return Key(k1, k2); }
+
+			/**
+			 * Compares two keys.
+			 *
+			 * @param   Key
+			 * @param   Key
+			 * @return  bool
+			 */
+			static bool less(const Key& p1, const Key& p2)
+			{
+				if (Math::less(p1.first, p2.first))				return true;
+				else if (Math::greater(p1.first, p2.first))		return false;
+				else if (Math::less(p1.second,  p2.second))		return true;
+				else if (Math::greater(p1.second, p2.second))	return false;
+																return false;
+			}
+
+			/**
+			 * Gets the first key component in map cost units.
+			 *
+			 * @param   Key
+			 * @return  double
+			 */
+			static double primary(const Key& k) { return k.first; }
+
+			/**
+			 * Converts to a map cost.
+			 *
+			 * @param   double
+			 * @return  double   map cost
+			 */
+			static double to(double v) { return v; }
+	};
+
+	/**
+	 * Float costs (half the state memory of doubles).
+	 */
+	template <>
+	class Cost<float>
+	{
+		public:
+
+			/**
+			 * @var  typedef  key (pair of floats)
+			 */
+			typedef pair<float,float> Key;
+
+			/**
+			 * @var  float  infinite cost
+			 */
+			static float inf() { return FLT_MAX; }
+
+			/**
+			 * @see  Cost<double>
+			 */
+			static float add(float a, float b) { return a + b; }
+
+			/**
+			 * @see  Cost<double>
+			 */
+			static float bound(double v) { return (float) (v * (1.0 - 1e-4)); }
+
+			/**
+			 * @see  Cost<double>
+			 */
+			static bool equals(float a, float b) { return a == b; }
+
+			/**
+			 * @see  Cost<double>
+			 */
+			static float from(double v) { return (v >= FLT_MAX) ? FLT_MAX : (float) v; }
+
+			/**
+			 * @see  Cost<double>
+			 */
+			static bool greater(float a, float b) { return a > b; }
+
+			/**
+			 * Calculates the octile heuristic, lowered like bound() so rounded
+			 * keys of cells on the path never pass the start's.
+			 *
+			 * @param   unsigned int   smaller coordinate difference
+			 * @param   unsigned int   larger coordinate difference
+			 * @return  float
+			 */
+			static float octile(unsigned int min, unsigned int max) { return bound((Math::SQRT2 - 1.0) * min + max); }
+
+			/**
+			 * @see  Cost<double>
+			 */
+			static Key key(float k1, float k2) { return Key(k1, k2); }
+
+			/**
+			 * @see  Cost<double>
+			 */
+			static bool less(const Key& p1, const Key& p2)
+			{
+				return p1.first < p2.first || (p1.first == p2.first && p1.second < p2.second);
+			}
+
+			/**
+			 * @see  Cost<double>
+			 */
+			static double primary(const Key& k) { return k.first; }
+
+			/**
+			 * @see  Cost<double>
+			 */
+			static double to(float v) { return (v == FLT_MAX) ? Math::INF : v; }
+	};
+
+	/**
+	 * Fixed point costs.
+	 *
+	 * Both key components fit in 32 bits, so a key is packed into a single
+	 * 64-bit integer and comparing keys is one integer compare. Additions
+	 * saturate at inf().
+	 */
+	template <>
+	class Cost<Fixed>
+	{
+		public:
+
+			/**
+			 * @var  typedef  key (first component in the high word)
+			 */
+			typedef uint64_t Key;
+
+			/**
+			 * @var  static const Fixed  fixed point one
+			 */
+			static const Fixed ONE = 256;
+
+			/**
+			 * @var  static const Fixed  fixed point SQRT2, rounded down so octile stays a lower bound
+			 */
+			static const Fixed DIAGONAL = 362;
+
+			/**
+			 * @see  Cost<double>
+			 */
+			static Fixed inf() { return 0xFFFFFFFF; }
+
+			/**
+			 * @see  Cost<double>
+			 */
+			static Fixed add(Fixed a, Fixed b) { return (a >= inf() - b) ? inf() : a + b; }
+
+			/**
+			 * Rounds down, see from().
+			 */
+			static Fixed bound(double v) { return (v * ONE >= inf()) ? inf() : (Fixed) floor(v * ONE); }
+
+			/**
+			 * @see  Cost<double>
+			 */
+			static bool equals(Fixed a, Fixed b) { return a == b; }
+
+			/**
+			 * Rounds up, so a heuristic rounded down never exceeds a path's cost.
+			 */
+			static Fixed from(double v) { return (v * ONE >= inf()) ? inf() : (Fixed) ceil(v * ONE); }
+
+			/**
+			 * @see  Cost<double>
+			 */
+			static bool greater(Fixed a, Fixed b) { return a > b; }
+
+			/**
+			 * @see  Cost<double>
+			 */
+			static Fixed octile(unsigned int min, unsigned int max) { return DIAGONAL * min + ONE * (max - min); }
+
+			/**
+			 * @see  Cost<double>
+			 */
+			static Key key(Fixed k1, Fixed k2) { return ((Key) k1 << 32) | k2; }
+
+			/**
+			 * @see  Cost<double>
+			 */
+			static bool less(Key p1, Key p2) { return p1 < p2; }
+
+			/**
+			 * @see  Cost<double>
+			 */
+			static double primary(Key k) { return (double) (Fixed) (k >> 32) / ONE; }
+
+			/**
+			 * @see  Cost<double>
+			 */
+			static double to(Fixed v) { return (v == inf()) ? Math::INF : (double) v / ONE; }
+	};
+};
+
+#endif // DSTARLITE_COST_H
@@ -0,0 +1,351 @@
+/**
+ * Cost Layer.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#include <cmath>
+#include <cstring>
+#ifdef WIN32
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#include "cost_layer.h"
+#include "map.h"
+
+using namespace DStarLite;
+
+/**
+ * Constructor.
+ *
+ * @param  unsigned int          number of cells
+ * @param  Format                storage format
+ * @param  double [optional]     cost of every cell
+ */
+CostLayer::CostLayer(unsigned int size, Format format, double cost)
+{
+	_size = size;
+	_format = format;
+	_mapping = NULL;
+	_mapping_length = 0;
+
+	_allocate();
+
+	for (unsigned int i = 0; i < _size; i++)
+	{
+		set(i, cost);
+	}
+}
+
+/**
+ * Copy constructor.
+ *
+ * @param  CostLayer   layer to copy
+ */
+CostLayer::CostLayer(const CostLayer& layer)
+{
+	_size = layer._size;
+	_format = layer._format;
+	_mapping = NULL;
+	_mapping_length = 0;
+
+	// Copies always get their own memory
+	_allocate();
+
+	if (_costs != NULL)
+	{
+		memcpy(_costs, layer._costs, sizeof(double) * _size);
+	}
+	else if (_codes8 != NULL)
+	{
+		memcpy(_codes8, layer._codes8, sizeof(uint8_t) * _size);
+	}
+	else
+	{
+		memcpy(_codes16, layer._codes16, sizeof(uint16_t) * _size);
+	}
+}
+
+/**
+ * Constructor (mapped storage, see map()).
+ *
+ * @param  unsigned int   number of cells
+ * @param  Format         storage format
+ * @param  void*          start of the mapped file
+ * @param  size_t         length of the mapped file
+ * @param  size_t         byte offset of the costs
+ */
+CostLayer::CostLayer(unsigned int size, Format format, void* mapping, size_t length, size_t offset)
+{
+	_size = size;
+	_format = format;
+	_mapping = mapping;
+	_mapping_length = length;
+
+	_allocate((char*) mapping + offset);
+}
+
+/**
+ * Deconstructor.
+ */
+CostLayer::~CostLayer()
+{
+	if (_mapping != NULL)
+	{
+#ifdef WIN32
+		UnmapViewOfFile(_mapping);
+#else
+		munmap(_mapping, _mapping_length);
+#endif
+	}
+	else
+	{
+		delete[] _codes16;
+		delete[] _codes8;
+		delete[] _costs;
+	}
+
+	delete[] _decode;
+}
+
+/**
+ * Gets the memory used by the costs.
+ *
+ * @return  size_t   bytes
+ */
+size_t CostLayer::bytes()
+{
+	switch (_format)
+	{
+		case FORMAT_UINT8:
+			return sizeof(uint8_t) * _size + sizeof(double) * 0x100;
+
+		case FORMAT_UINT16:
+			return sizeof(uint16_t) * _size + sizeof(double) * 0x10000;
+
+		default:
+			return sizeof(double) * _size;
+	}
+}
+
+/**
+ * Gets the raw costs (doubles or codes, row-major).
+ *
+ * @return  void*
+ */
+void* CostLayer::data()
+{
+	if (_codes8 != NULL)
+		return _codes8;
+
+	if (_codes16 != NULL)
+		return _codes16;
+
+	return _costs;
+}
+
+/**
+ * Gets the storage format.
+ *
+ * @return  Format
+ */
+CostLayer::Format CostLayer::format()
+{
+	return _format;
+}
+
+/**
+ * Maps costs from a file.
+ *
+ * @param   char*          file name
+ * @param   size_t         byte offset of the costs (aligned to the format)
+ * @param   unsigned int   number of cells
+ * @param   Format         storage format
+ * @return  CostLayer*     layer (NULL if the file can't be mapped or is too short)
+ */
+CostLayer* CostLayer::map(const char* file, size_t offset, unsigned int size, Format format)
+{
+	size_t cell = (format == FORMAT_UINT8) ? sizeof(uint8_t) : (format == FORMAT_UINT16) ? sizeof(uint16_t) : sizeof(double);
+
+	if (offset % cell != 0)
+		return NULL;
+
+	// Counted wide, so a huge size can't wrap around on 32 bit builds
+	unsigned long long needed = (unsigned long long) offset + (unsigned long long) cell * size;
+	void* mapping = NULL;
+	size_t length = 0;
+
+#ifdef WIN32
+	HANDLE f = CreateFileA(file, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if (f == INVALID_HANDLE_VALUE)
+		return NULL;
+
+	LARGE_INTEGER bytes;
+
+	if (GetFileSizeEx(f, &bytes) && (unsigned long long) bytes.QuadPart >= needed)
+	{
+		length = (size_t) bytes.QuadPart;
+
+		HANDLE m = CreateFileMappingA(f, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+
+		if (m != NULL)
+		{
+			// The view keeps the mapping alive
+			mapping = MapViewOfFile(m, FILE_MAP_COPY, 0, 0, 0);
+			CloseHandle(m);
+		}
+	}
+
+	CloseHandle(f);
+#else
+	int f = open(file, O_RDONLY);
+
+	if (f < 0)
+		return NULL;
+
+	struct stat info;
+
+	if (fstat(f, &info) == 0 && (unsigned long long) info.st_size >= needed)
+	{
+		length = (size_t) info.st_size;
+
+		// Private, so setting a cost copies only its page
+		mapping = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, f, 0);
+
+		if (mapping == MAP_FAILED)
+		{
+			mapping = NULL;
+		}
+	}
+
+	close(f);
+#endif
+
+	if (mapping == NULL)
+		return NULL;
+
+	return new CostLayer(size, format, mapping, length, offset);
+}
+
+/**
+ * Checks if the layer sits on a mapped file.
+ *
+ * @return  bool
+ */
+bool CostLayer::mapped()
+{
+	return _mapping != NULL;
+}
+
+/**
+ * Sets a cost.
+ *
+ * @param   unsigned int   cell index
+ * @param   double         cost
+ * @return  void
+ */
+void CostLayer::set(unsigned int i, double cost)
+{
+	if (_codes8 != NULL)
+	{
+		_codes8[i] = (uint8_t) _encode(cost);
+	}
+	else if (_codes16 != NULL)
+	{
+		_codes16[i] = (uint16_t) _encode(cost);
+	}
+	else
+	{
+		_costs[i] = cost;
+	}
+}
+
+/**
+ * Gets the number of cells.
+ *
+ * @return  unsigned int
+ */
+unsigned int CostLayer::size()
+{
+	return _size;
+}
+
+/**
+ * Allocates the storage and decode table.
+ *
+ * @param   void* [optional]   storage to use instead of allocating
+ * @return  void
+ */
+void CostLayer::_allocate(void* storage)
+{
+	_codes16 = NULL;
+	_codes8 = NULL;
+	_costs = NULL;
+	_decode = NULL;
+
+	unsigned int codes = 0;
+
+	switch (_format)
+	{
+		case FORMAT_UINT8:
+			_codes8 = (storage != NULL) ? (uint8_t*) storage : new uint8_t[_size];
+			codes = 0x100;
+			break;
+
+		case FORMAT_UINT16:
+			_codes16 = (storage != NULL) ? (uint16_t*) storage : new uint16_t[_size];
+			codes = 0x10000;
+			break;
+
+		default:
+			_costs = (storage != NULL) ? (double*) storage : new double[_size];
+			return;
+	}
+
+	_decode = new double[codes];
+	_decode[CODE_UNWALKABLE] = Map::Cell::COST_UNWALKABLE;
+
+	for (unsigned int i = 1; i < codes; i++)
+	{
+		_decode[i] = i * _step();
+	}
+}
+
+/**
+ * Encodes a cost.
+ *
+ * @param   double         cost
+ * @return  unsigned int   code
+ */
+unsigned int CostLayer::_encode(double cost)
+{
+	if (cost == Map::Cell::COST_UNWALKABLE)
+		return CODE_UNWALKABLE;
+
+	double max = (_format == FORMAT_UINT8) ? 0xFF : 0xFFFF;
+	double code = floor(cost / _step() + 0.5);
+
+	// Walkable cells never take the unwalkable code
+	if (code < 1)
+		return 1;
+
+	return (code > max) ? (unsigned int) max : (unsigned int) code;
+}
+
+/**
+ * Gets the cost of one code step.
+ *
+ * @return  double
+ */
+double CostLayer::_step()
+{
+	return (_format == FORMAT_UINT16) ? 1.0 / 256 : 1.0;
+}
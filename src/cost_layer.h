@@ -0,0 +1,239 @@
+/**
+ * Cost Layer.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#ifndef DSTARLITE_COST_LAYER_H
+#define DSTARLITE_COST_LAYER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace DStarLite
+{
+	/**
+	 * Cell costs in row-major order.
+	 *
+	 * Costs are either plain doubles or compact codes. Code 0 is reserved for
+	 * unwalkable cells, every other code is decoded through a table, so a
+	 * read is one load and one table lookup with no branch on walkability.
+	 * 8-bit codes hold whole costs 1 to 255 (all a bitmap pixel can give),
+	 * 16-bit codes hold costs in steps of 1/256 up to 255.99. Costs written
+	 * to a compact layer are rounded to the nearest code.
+	 *
+	 * A layer can also sit on a memory mapped file (see Costmap). The mapping
+	 * is copy-on-write: pages stay shared with other processes until a cost
+	 * on them is set, and the file itself is never written.
+	 */
+	class CostLayer
+	{
+		public:
+
+			/**
+			 * Storage formats.
+			 */
+			enum Format
+			{
+				/**
+				 * 8 bytes per cell, exact (default).
+				 */
+				FORMAT_DOUBLE,
+
+				/**
+				 * 1 byte per cell.
+				 */
+				FORMAT_UINT8,
+
+				/**
+				 * 2 bytes per cell.
+				 */
+				FORMAT_UINT16
+			};
+
+			/**
+			 * @var  static const unsigned int  code of an unwalkable cell
+			 */
+			static const unsigned int CODE_UNWALKABLE = 0;
+
+			/**
+			 * Constructor.
+			 *
+			 * @param  unsigned int          number of cells
+			 * @param  Format                storage format
+			 * @param  double [optional]     cost of every cell
+			 */
+			CostLayer(unsigned int size, Format format = FORMAT_DOUBLE, double cost = 1.0);
+
+			/**
+			 * Copy constructor.
+			 *
+			 * @param  CostLayer   layer to copy
+			 */
+			CostLayer(const CostLayer& layer);
+
+			/**
+			 * Deconstructor.
+			 */
+			~CostLayer();
+
+			/**
+			 * Gets the memory used by the costs.
+			 *
+			 * @return  size_t   bytes
+			 */
+			size_t bytes();
+
+			/**
+			 * Gets the raw costs (doubles or codes, row-major).
+			 *
+			 * @return  void*
+			 */
+			void* data();
+
+			/**
+			 * Gets the storage format.
+			 *
+			 * @return  Format
+			 */
+			Format format();
+
+			/**
+			 * Maps costs from a file.
+			 *
+			 * @param   char*          file name
+			 * @param   size_t         byte offset of the costs (aligned to the format)
+			 * @param   unsigned int   number of cells
+			 * @param   Format         storage format
+			 * @return  CostLayer*     layer (NULL if the file can't be mapped or is too short)
+			 */
+			static CostLayer* map(const char* file, size_t offset, unsigned int size, Format format);
+
+			/**
+			 * Checks if the layer sits on a mapped file.
+			 *
+			 * @return  bool
+			 */
+			bool mapped();
+
+			/**
+			 * Gets a cost.
+			 *
+			 * @param   unsigned int   cell index
+			 * @return  double         cost
+			 */
+			double get(unsigned int i)
+			{
+				if (_codes8 != NULL)
+					return _decode[_codes8[i]];
+
+				if (_codes16 != NULL)
+					return _decode[_codes16[i]];
+
+				return _costs[i];
+			}
+
+			/**
+			 * Sets a cost.
+			 *
+			 * @param   unsigned int   cell index
+			 * @param   double         cost
+			 * @return  void
+			 */
+			void set(unsigned int i, double cost);
+
+			/**
+			 * Gets the number of cells.
+			 *
+			 * @return  unsigned int
+			 */
+			unsigned int size();
+
+		protected:
+
+			/**
+			 * @var  uint16_t*  16-bit codes (NULL unless FORMAT_UINT16)
+			 */
+			uint16_t* _codes16;
+
+			/**
+			 * @var  uint8_t*  8-bit codes (NULL unless FORMAT_UINT8)
+			 */
+			uint8_t* _codes8;
+
+			/**
+			 * @var  double*  costs (NULL unless FORMAT_DOUBLE)
+			 */
+			double* _costs;
+
+			/**
+			 * @var  double*  cost of every code (NULL for FORMAT_DOUBLE)
+			 */
+			double* _decode;
+
+			/**
+			 * @var  Format  storage format
+			 */
+			Format _format;
+
+			/**
+			 * @var  void*  start of the mapped file (NULL unless mapped)
+			 */
+			void* _mapping;
+
+			/**
+			 * @var  size_t  length of the mapped file
+			 */
+			size_t _mapping_length;
+
+			/**
+			 * @var  unsigned int  number of cells
+			 */
+			unsigned int _size;
+
+			/**
+			 * Constructor (mapped storage, see map()).
+			 *
+			 * @param  unsigned int   number of cells
+			 * @param  Format         storage format
+			 * @param  void*          start of the mapped file
+			 * @param  size_t         length of the mapped file
+			 * @param  size_t         byte offset of the costs
+			 */
+			CostLayer(unsigned int size, Format format, void* mapping, size_t length, size_t offset);
+
+			/**
+			 * Allocates the storage and decode table.
+			 *
+			 * @param   void* [optional]   storage to use instead of allocating
+			 * @return  void
+			 */
+			void _allocate(void* storage = NULL);
+
+			/**
+			 * Encodes a cost.
+			 *
+			 * @param   double         cost
+			 * @return  unsigned int   code
+			 */
+			unsigned int _encode(double cost);
+
+			/**
+			 * Gets the cost of one code step.
+			 *
+			 * @return  double
+			 */
+			double _step();
+
+		private:
+
+			/**
+			 * Not assignable.
+			 */
+			CostLayer& operator=(const CostLayer&);
+	};
+};
+
+#endif // DSTARLITE_COST_LAYER_H
@@ -0,0 +1,122 @@
+/**
+ * Costmap.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#define _CRT_SECURE_NO_WARNINGS
+#include <climits>
+#include <cstdio>
+#include <cstring>
+
+#include "costmap.h"
+
+using namespace DStarLite;
+
+/**
+ * @var  static const char*  magic
+ */
+const char* Costmap::MAGIC = "DSLC";
+
+/**
+ * Opens a costmap file.
+ *
+ * The costs stay in the file mapping (see CostLayer::map()).
+ *
+ * @param   char*   file name
+ * @return  Map*    contiguous map (NULL if the file is missing, not a
+ *                  costmap, another version or byte order, too large to
+ *                  count its cells, or short)
+ */
+Map* Costmap::load(const char* file)
+{
+	FILE* fp = fopen(file, "rb");
+
+	if (fp == NULL)
+		return NULL;
+
+	Header header;
+	size_t read = fread(&header, sizeof(Header), 1, fp);
+
+	fclose(fp);
+
+	if (read != 1 || memcmp(header.magic, MAGIC, 4) != 0)
+		return NULL;
+
+	if (header.version != VERSION || header.order != ORDER)
+		return NULL;
+
+	if (header.format > CostLayer::FORMAT_UINT16 || header.rows == 0 || header.cols == 0)
+		return NULL;
+
+	// Cells are counted in unsigned ints, a product that wraps would pass
+	// the size check and map too few bytes
+	if (header.rows > UINT_MAX / header.cols)
+		return NULL;
+
+	CostLayer* costs = CostLayer::map(file, header.offset, header.rows * header.cols, (CostLayer::Format) header.format);
+
+	if (costs == NULL)
+		return NULL;
+
+	return new Map(header.rows, header.cols, costs);
+}
+
+/**
+ * Saves a map as a costmap file.
+ *
+ * @param   char*               file name
+ * @param   Map*                map
+ * @param   CostLayer::Format   format of the file
+ * @return  bool                successful
+ */
+bool Costmap::save(const char* file, Map* map, CostLayer::Format format)
+{
+	Header header;
+	memset(&header, 0, sizeof(Header));
+	memcpy(header.magic, MAGIC, 4);
+	header.version = VERSION;
+	header.order = ORDER;
+	header.format = format;
+	header.rows = map->rows();
+	header.cols = map->cols();
+	header.offset = sizeof(Header);
+
+	// Encode through a layer, unless the map already holds the right one
+	CostLayer* costs = map->costs();
+	CostLayer* layer = NULL;
+
+	if (costs == NULL || costs->format() != format)
+	{
+		layer = new CostLayer(map->rows() * map->cols(), format);
+
+		for (unsigned int i = 0; i < map->rows(); i++)
+		{
+			for (unsigned int j = 0; j < map->cols(); j++)
+			{
+				layer->set(i * map->cols() + j, map->cost((*map)(i, j)));
+			}
+		}
+
+		costs = layer;
+	}
+
+	size_t cell = (format == CostLayer::FORMAT_UINT8) ? sizeof(uint8_t) : (format == CostLayer::FORMAT_UINT16) ? sizeof(uint16_t) : sizeof(double);
+
+	FILE* fp = fopen(file, "wb");
+	bool result = false;
+
+	if (fp != NULL)
+	{
+		result = fwrite(&header, sizeof(Header), 1, fp) == 1
+			&& fwrite(costs->data(), cell, costs->size(), fp) == costs->size();
+
+		result = (fclose(fp) == 0) && result;
+	}
+
+	delete layer;
+
+	return result;
+}
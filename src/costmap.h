@@ -0,0 +1,93 @@
+/**
+ * Costmap.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#ifndef DSTARLITE_COSTMAP_H
+#define DSTARLITE_COSTMAP_H
+
+#include <stdint.h>
+
+#include "cost_layer.h"
+#include "map.h"
+
+namespace DStarLite
+{
+	/**
+	 * Binary costmap file.
+	 *
+	 * A fixed 64 byte header followed by the row-major costs exactly as a
+	 * CostLayer stores them (codes or doubles, native byte order), so a map
+	 * opens by mapping the file, with nothing to parse or convert:
+	 *
+	 *   0   char[4]    magic "DSLC"
+	 *   4   uint32     version
+	 *   8   uint32     byte order mark (0x01020304 as written)
+	 *   12  uint32     format (CostLayer::Format)
+	 *   16  uint32     rows
+	 *   20  uint32     columns
+	 *   24  uint32     byte offset of the costs (64)
+	 *   28  ...        reserved (zero)
+	 */
+	class Costmap
+	{
+		public:
+
+			/**
+			 * File header.
+			 */
+			struct Header
+			{
+				char magic[4];
+				uint32_t version;
+				uint32_t order;
+				uint32_t format;
+				uint32_t rows;
+				uint32_t cols;
+				uint32_t offset;
+				uint32_t reserved[9];
+			};
+
+			/**
+			 * @var  static const char*  magic
+			 */
+			static const char* MAGIC;
+
+			/**
+			 * @var  static const uint32_t  byte order mark
+			 */
+			static const uint32_t ORDER = 0x01020304;
+
+			/**
+			 * @var  static const uint32_t  current version
+			 */
+			static const uint32_t VERSION = 1;
+
+			/**
+			 * Opens a costmap file.
+			 *
+			 * The costs stay in the file mapping (see CostLayer::map()).
+			 *
+			 * @param   char*   file name
+			 * @return  Map*    contiguous map (NULL if the file is missing, not a
+			 *                  costmap, another version or byte order, too large
+			 *                  to count its cells, or short)
+			 */
+			static Map* load(const char* file);
+
+			/**
+			 * Saves a map as a costmap file.
+			 *
+			 * @param   char*               file name
+			 * @param   Map*                map
+			 * @param   CostLayer::Format   format of the file
+			 * @return  bool                successful
+			 */
+			static bool save(const char* file, Map* map, CostLayer::Format format);
+	};
+};
+
+#endif // DSTARLITE_COSTMAP_H
@@ -0,0 +1,124 @@
+/**
+ * Diff.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#include "diff.h"
+
+#ifndef DSTARLITE_NO_SIMD
+	#if defined(__AVX2__)
+		#define DSTARLITE_AVX2
+	#endif
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define DSTARLITE_SSE2
+	#endif
+#endif
+
+#if defined(DSTARLITE_AVX2)
+	#include <immintrin.h>
+#elif defined(DSTARLITE_SSE2)
+	#include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+	#include <intrin.h>
+#endif
+
+using namespace DStarLite;
+
+/**
+ * Finds the indices where two buffers differ in a span.
+ *
+ * @param   const unsigned char*    buffer a
+ * @param   const unsigned char*    buffer b
+ * @param   unsigned int            first index
+ * @param   unsigned int            index past the end
+ * @param   vector<unsigned int>&   changed indices
+ * @return  unsigned int            indices appended
+ */
+unsigned int Diff::span(const unsigned char* a, const unsigned char* b, unsigned int begin, unsigned int end, vector<unsigned int>& changed)
+{
+	unsigned int size = (unsigned int) changed.size();
+	unsigned int k = begin;
+
+#ifdef DSTARLITE_AVX2
+	for (; k + 32 <= end; k += 32)
+	{
+		__m256i equal = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*) (a + k)), _mm256_loadu_si256((const __m256i*) (b + k)));
+		unsigned int mask = ~ (unsigned int) _mm256_movemask_epi8(equal);
+
+		if (mask != 0)
+		{
+			_emit(k, mask, changed);
+		}
+	}
+#endif
+
+#ifdef DSTARLITE_SSE2
+	for (; k + 16 <= end; k += 16)
+	{
+		__m128i equal = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) (a + k)), _mm_loadu_si128((const __m128i*) (b + k)));
+		unsigned int mask = ~ (unsigned int) _mm_movemask_epi8(equal) & 0xFFFF;
+
+		if (mask != 0)
+		{
+			_emit(k, mask, changed);
+		}
+	}
+#endif
+
+	// Tail (or everything without SIMD)
+	for (; k < end; k++)
+	{
+		if (a[k] != b[k])
+		{
+			changed.push_back(k);
+		}
+	}
+
+	return (unsigned int) changed.size() - size;
+}
+
+/**
+ * Gets the instruction set in use.
+ *
+ * @return  const char*   "avx2", "sse2" or "scalar"
+ */
+const char* Diff::target()
+{
+#if defined(DSTARLITE_AVX2)
+	return "avx2";
+#elif defined(DSTARLITE_SSE2)
+	return "sse2";
+#else
+	return "scalar";
+#endif
+}
+
+/**
+ * Appends the indices of the set bits of a mask.
+ *
+ * @param   unsigned int            index of bit 0
+ * @param   unsigned int            mask
+ * @param   vector<unsigned int>&   changed indices
+ * @return  void
+ */
+void Diff::_emit(unsigned int base, unsigned int mask, vector<unsigned int>& changed)
+{
+	while (mask != 0)
+	{
+#ifdef _MSC_VER
+		unsigned long bit;
+		_BitScanForward(&bit, mask);
+#else
+		unsigned int bit = __builtin_ctz(mask);
+#endif
+
+		changed.push_back(base + bit);
+
+		// Clear the lowest set bit
+		mask &= mask - 1;
+	}
+}
@@ -0,0 +1,64 @@
+/**
+ * Diff.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#ifndef DSTARLITE_DIFF_H
+#define DSTARLITE_DIFF_H
+
+#include <vector>
+
+using namespace std;
+
+namespace DStarLite
+{
+	/**
+	 * Byte buffer comparison.
+	 *
+	 * Compares 32 bytes at a time with AVX2 or 16 with SSE2, whichever the
+	 * compiler targets (define DSTARLITE_NO_SIMD to force plain bytes), so
+	 * a span with no changes costs a handful of compares.
+	 */
+	class Diff
+	{
+		public:
+
+			/**
+			 * Finds the indices where two buffers differ in a span.
+			 *
+			 * Indices are appended in increasing order.
+			 *
+			 * @param   const unsigned char*    buffer a
+			 * @param   const unsigned char*    buffer b
+			 * @param   unsigned int            first index
+			 * @param   unsigned int            index past the end
+			 * @param   vector<unsigned int>&   changed indices
+			 * @return  unsigned int            indices appended
+			 */
+			static unsigned int span(const unsigned char* a, const unsigned char* b, unsigned int begin, unsigned int end, vector<unsigned int>& changed);
+
+			/**
+			 * Gets the instruction set in use.
+			 *
+			 * @return  const char*   "avx2", "sse2" or "scalar"
+			 */
+			static const char* target();
+
+		protected:
+
+			/**
+			 * Appends the indices of the set bits of a mask.
+			 *
+			 * @param   unsigned int            index of bit 0
+			 * @param   unsigned int            mask
+			 * @param   vector<unsigned int>&   changed indices
+			 * @return  void
+			 */
+			static void _emit(unsigned int base, unsigned int mask, vector<unsigned int>& changed);
+	};
+};
+
+#endif // DSTARLITE_DIFF_H
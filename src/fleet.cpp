@@ -0,0 +1,193 @@
+/**
+ * Fleet.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#include "fleet.h"
+#include "timer.h"
+#include "trace.h"
+
+/**
+ * Constructor.
+ *
+ * @param  Planner*   planner
+ */
+Fleet::Agent::Agent(Planner* planner)
+{
+	this->planner = planner;
+
+	active = true;
+	latency = 0;
+	latency_max = 0;
+	latency_total = 0;
+	replans = 0;
+	solved = false;
+}
+
+/**
+ * Deconstructor.
+ */
+Fleet::Agent::~Agent()
+{
+	delete planner;
+}
+
+/**
+ * Constructor.
+ */
+Fleet::Stats::Stats()
+{
+	agents = 0;
+	latency_max = 0;
+	latency_mean = 0;
+	latency_total = 0;
+	solved = 0;
+	wall = 0;
+}
+
+/**
+ * Constructor.
+ *
+ * @param  Map*                       shared map (read only while ticking)
+ * @param  unsigned int [optional]    threads (0 for one per hardware thread)
+ * @param  Planner::Config            config options for every planner
+ */
+Fleet::Fleet(Map* map, unsigned int threads, Planner::Config config) : _pool(threads)
+{
+	_map = map;
+	_config = config;
+}
+
+/**
+ * Deconstructor.
+ */
+Fleet::~Fleet()
+{
+	for (unsigned int i = 0; i < _agents.size(); i++)
+	{
+		delete _agents[i];
+	}
+}
+
+/**
+ * Adds an agent.
+ *
+ * @param   Map::Cell*     start
+ * @param   Map::Cell*     goal
+ * @return  unsigned int   agent index
+ */
+unsigned int Fleet::add(Map::Cell* start, Map::Cell* goal)
+{
+	_agents.push_back(new Agent(new Planner(_map, start, goal, _config)));
+
+	return (unsigned int) _agents.size() - 1;
+}
+
+/**
+ * Gets an agent.
+ *
+ * @param   unsigned int   agent index
+ * @return  Agent*
+ */
+Fleet::Agent* Fleet::agent(unsigned int i)
+{
+	return _agents[i];
+}
+
+/**
+ * Gets the number of agents.
+ *
+ * @return  unsigned int
+ */
+unsigned int Fleet::size()
+{
+	return (unsigned int) _agents.size();
+}
+
+/**
+ * Hands every active agent its queued changes and replans them all in parallel.
+ *
+ * @return  Stats
+ */
+Fleet::Stats Fleet::tick()
+{
+	DSTARLITE_TRACE_SCOPE("tick");
+
+	Stats stats;
+	Timer timer;
+
+	_pool.run(Fleet::_replan, (void*) this, (unsigned int) _agents.size());
+
+	stats.wall = timer.elapsed();
+
+	for (unsigned int i = 0; i < _agents.size(); i++)
+	{
+		Agent* a = _agents[i];
+
+		if ( ! a->active)
+			continue;
+
+		stats.agents++;
+		stats.latency_total += a->latency;
+
+		if (a->latency > stats.latency_max)
+		{
+			stats.latency_max = a->latency;
+		}
+
+		if (a->solved)
+		{
+			stats.solved++;
+		}
+	}
+
+	if (stats.agents > 0)
+	{
+		stats.latency_mean = stats.latency_total / stats.agents;
+	}
+
+	return stats;
+}
+
+/**
+ * Gets the number of threads.
+ *
+ * @return  unsigned int
+ */
+unsigned int Fleet::threads()
+{
+	return _pool.size();
+}
+
+/**
+ * Updates and replans one agent (thread pool task).
+ *
+ * @param   void*          fleet
+ * @param   unsigned int   agent index
+ * @return  void
+ */
+void Fleet::_replan(void* fleet, unsigned int i)
+{
+	Agent* a = ((Fleet*) fleet)->_agents[i];
+
+	if ( ! a->active)
+		return;
+
+	Timer timer;
+
+	a->planner->update_batch(a->changes);
+	a->changes.clear();
+	a->solved = a->planner->replan();
+
+	a->latency = timer.elapsed();
+	a->latency_total += a->latency;
+	a->replans++;
+
+	if (a->latency > a->latency_max)
+	{
+		a->latency_max = a->latency;
+	}
+}
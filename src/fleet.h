@@ -0,0 +1,222 @@
+/**
+ * Fleet.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#ifndef DSTARLITE_FLEET_H
+#define DSTARLITE_FLEET_H
+
+#include <vector>
+
+#include "map.h"
+#include "planner.h"
+#include "thread_pool.h"
+
+using namespace std;
+using namespace DStarLite;
+
+namespace DStarLite
+{
+	/**
+	 * Many agents planning over one shared map.
+	 *
+	 * Every agent has its own Planner. Planners only read the map (their cost
+	 * updates stay private, see Planner::cost()), so tick() replans all of
+	 * them at once on a thread pool.
+	 */
+	class Fleet
+	{
+		public:
+
+			/**
+			 * Agent.
+			 */
+			class Agent
+			{
+				public:
+
+					/**
+					 * @var  bool  replanned by tick() (agents that are done can be switched off)
+					 */
+					bool active;
+
+					/**
+					 * @var  vector<pair<Map::Cell*,double> >  cost changes for the next tick
+					 */
+					vector<pair<Map::Cell*,double> > changes;
+
+					/**
+					 * @var  double  seconds spent in the last tick (update and replan)
+					 */
+					double latency;
+
+					/**
+					 * @var  double  most seconds spent in one tick
+					 */
+					double latency_max;
+
+					/**
+					 * @var  double  seconds spent in all ticks
+					 */
+					double latency_total;
+
+					/**
+					 * @var  Planner*  planner
+					 */
+					Planner* planner;
+
+					/**
+					 * @var  unsigned int  replans so far
+					 */
+					unsigned int replans;
+
+					/**
+					 * @var  bool  last replan found a path
+					 */
+					bool solved;
+
+					/**
+					 * Constructor.
+					 *
+					 * @param  Planner*   planner
+					 */
+					Agent(Planner* planner);
+
+					/**
+					 * Deconstructor.
+					 */
+					~Agent();
+			};
+
+			/**
+			 * Tick stats.
+			 */
+			class Stats
+			{
+				public:
+
+					/**
+					 * @var  unsigned int  active agents replanned
+					 */
+					unsigned int agents;
+
+					/**
+					 * @var  double  slowest agent, seconds
+					 */
+					double latency_max;
+
+					/**
+					 * @var  double  mean agent latency, seconds
+					 */
+					double latency_mean;
+
+					/**
+					 * @var  double  sum of agent latencies, seconds (CPU time spent planning)
+					 */
+					double latency_total;
+
+					/**
+					 * @var  unsigned int  agents with a path
+					 */
+					unsigned int solved;
+
+					/**
+					 * @var  double  wall time of the tick, seconds
+					 */
+					double wall;
+
+					/**
+					 * Constructor.
+					 */
+					Stats();
+			};
+
+			/**
+			 * Constructor.
+			 *
+			 * @param  Map*                       shared map (read only while ticking)
+			 * @param  unsigned int [optional]    threads (0 for one per hardware thread)
+			 * @param  Planner::Config            config options for every planner
+			 */
+			Fleet(Map* map, unsigned int threads = 0, Planner::Config config = Planner::Config());
+
+			/**
+			 * Deconstructor.
+			 */
+			~Fleet();
+
+			/**
+			 * Adds an agent.
+			 *
+			 * @param   Map::Cell*     start
+			 * @param   Map::Cell*     goal
+			 * @return  unsigned int   agent index
+			 */
+			unsigned int add(Map::Cell* start, Map::Cell* goal);
+
+			/**
+			 * Gets an agent.
+			 *
+			 * @param   unsigned int   agent index
+			 * @return  Agent*
+			 */
+			Agent* agent(unsigned int i);
+
+			/**
+			 * Gets the number of agents.
+			 *
+			 * @return  unsigned int
+			 */
+			unsigned int size();
+
+			/**
+			 * Hands every active agent its queued changes and replans them all in parallel.
+			 *
+			 * @return  Stats
+			 */
+			Stats tick();
+
+			/**
+			 * Gets the number of threads.
+			 *
+			 * @return  unsigned int
+			 */
+			unsigned int threads();
+
+		protected:
+
+			/**
+			 * @var  vector<Agent*>  agents
+			 */
+			vector<Agent*> _agents;
+
+			/**
+			 * @var  Planner::Config  planner config options
+			 */
+			Planner::Config _config;
+
+			/**
+			 * @var  Map*  shared map
+			 */
+			Map* _map;
+
+			/**
+			 * @var  ThreadPool  thread pool
+			 */
+			ThreadPool _pool;
+
+			/**
+			 * Updates and replans one agent (thread pool task).
+			 *
+			 * @param   void*          fleet
+			 * @param   unsigned int   agent index
+			 * @return  void
+			 */
+			static void _replan(void* fleet, unsigned int i);
+	};
+};
+
+#endif // DSTARLITE_FLEET_H
@@ -0,0 +1,263 @@
+/**
+ * Heap.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#ifndef DSTARLITE_HEAP_H
+#define DSTARLITE_HEAP_H
+
+#include <vector>
+
+#include "open_list.h"
+
+using namespace std;
+
+namespace DStarLite
+{
+	/**
+	 * Indexed d-ary min heap.
+	 *
+	 * Every entry carries a pointer to its cell's position, so removing or
+	 * re-keying a cell is a sift from a known slot rather than a search.
+	 * Storage is a single vector that only grows, so steady state operations
+	 * never allocate.
+	 */
+	template <typename K, typename C, unsigned int D = 4>
+	class Heap : public OpenList<K,C>
+	{
+		public:
+
+			/**
+			 * @var  static const unsigned int  initial capacity
+			 */
+			static const unsigned int CAPACITY = 1024;
+
+			/**
+			 * Constructor.
+			 */
+			Heap()
+			{
+				_entries.reserve(CAPACITY);
+			}
+
+			/**
+			 * Removes all cells from the list.
+			 *
+			 * @return  void
+			 */
+			void clear()
+			{
+				for (unsigned int i = 0; i < _entries.size(); i++)
+				{
+					*_entries[i].pos = OpenList<K,C>::NONE;
+				}
+
+				_entries.clear();
+			}
+
+			/**
+			 * Checks if the list is empty.
+			 *
+			 * @return  bool
+			 */
+			bool empty()
+			{
+				return _entries.empty();
+			}
+
+			/**
+			 * Inserts a cell.
+			 *
+			 * @param   Map::Cell*       cell to insert
+			 * @param   K                key value for the cell
+			 * @param   unsigned int*    position of the cell
+			 * @return  void
+			 */
+			void insert(Map::Cell* u, K k, unsigned int* pos)
+			{
+				Entry e;
+				e.key = k;
+				e.cell = u;
+				e.pos = pos;
+
+				_entries.push_back(e);
+				_up((unsigned int) _entries.size() - 1, e);
+			}
+
+			/**
+			 * Removes a cell.
+			 *
+			 * @param   unsigned int*   position of the cell
+			 * @return  void
+			 */
+			void remove(unsigned int* pos)
+			{
+				unsigned int i = *pos;
+				*pos = OpenList<K,C>::NONE;
+
+				Entry last = _entries.back();
+				_entries.pop_back();
+
+				if (i == _entries.size())
+					return;
+
+				// Fill the hole with the last entry and restore the order
+				if (i > 0 && _compare(last.key, _entries[(i - 1) / D].key))
+				{
+					_up(i, last);
+				}
+				else
+				{
+					_down(i, last);
+				}
+			}
+
+			/**
+			 * Gets the number of cells in the list.
+			 *
+			 * @return  unsigned int
+			 */
+			unsigned int size()
+			{
+				return (unsigned int) _entries.size();
+			}
+
+			/**
+			 * Gets the cell with the smallest key.
+			 *
+			 * @return  Map::Cell*
+			 */
+			Map::Cell* top()
+			{
+				return _entries[0].cell;
+			}
+
+			/**
+			 * Gets the smallest key.
+			 *
+			 * @return  K
+			 */
+			K top_key()
+			{
+				return _entries[0].key;
+			}
+
+			/**
+			 * Changes the key of a cell (either direction).
+			 *
+			 * @param   unsigned int*   position of the cell
+			 * @param   K               new key value
+			 * @return  void
+			 */
+			void update(unsigned int* pos, K k)
+			{
+				unsigned int i = *pos;
+
+				Entry e = _entries[i];
+				bool decrease = _compare(k, e.key);
+				e.key = k;
+
+				if (decrease)
+				{
+					_up(i, e);
+				}
+				else
+				{
+					_down(i, e);
+				}
+			}
+
+		protected:
+
+			/**
+			 * Heap entry.
+			 */
+			struct Entry
+			{
+				K key;
+				Map::Cell* cell;
+				unsigned int* pos;
+			};
+
+			/**
+			 * @var  C  key compare
+			 */
+			C _compare;
+
+			/**
+			 * @var  vector<Entry>  entries in heap order
+			 */
+			vector<Entry> _entries;
+
+			/**
+			 * Sifts an entry down from a hole.
+			 *
+			 * @param   unsigned int   hole
+			 * @param   Entry          entry to place
+			 * @return  void
+			 */
+			void _down(unsigned int i, Entry e)
+			{
+				unsigned int n = (unsigned int) _entries.size();
+
+				while (true)
+				{
+					unsigned int first = i * D + 1;
+
+					if (first >= n)
+						break;
+
+					unsigned int last = (first + D < n) ? first + D : n;
+					unsigned int min = first;
+
+					for (unsigned int j = first + 1; j < last; j++)
+					{
+						if (_compare(_entries[j].key, _entries[min].key))
+						{
+							min = j;
+						}
+					}
+
+					if ( ! _compare(_entries[min].key, e.key))
+						break;
+
+					_entries[i] = _entries[min];
+					*_entries[i].pos = i;
+					i = min;
+				}
+
+				_entries[i] = e;
+				*e.pos = i;
+			}
+
+			/**
+			 * Sifts an entry up from a hole.
+			 *
+			 * @param   unsigned int   hole
+			 * @param   Entry          entry to place
+			 * @return  void
+			 */
+			void _up(unsigned int i, Entry e)
+			{
+				while (i > 0)
+				{
+					unsigned int parent = (i - 1) / D;
+
+					if ( ! _compare(e.key, _entries[parent].key))
+						break;
+
+					_entries[i] = _entries[parent];
+					*_entries[i].pos = i;
+					i = parent;
+				}
+
+				_entries[i] = e;
+				*e.pos = i;
+			}
+	};
+};
+
+#endif // DSTARLITE_HEAP_H
@@ -0,0 +1,1549 @@
+/**
+ * Hierarchical Planner.
+ *
+ * Based on "Near Optimal Hierarchical Path-Finding" by Adi Botea, Martin Muller
+ * and Jonathan Schaeffer, with D* Lite (see Planner) as the abstract search.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#include <functional>
+#include <queue>
+
+#include "hierarchical_planner.h"
+
+/*
+ * @var  static const double  max steps before assuming no solution possible
+ */
+const double HierarchicalPlanner::MAX_STEPS = 1000000;
+
+/**
+ * Constructor.
+ */
+HierarchicalPlanner::Config::Config()
+{
+	cluster_size = 32;
+	entrance_split = 6;
+}
+
+/**
+ * Constructor.
+ *
+ * @param  Map*         map
+ * @param  Map::Cell*   start cell
+ * @param  Map::Cell*   goal cell
+ * @param  Config       config options
+ */
+HierarchicalPlanner::HierarchicalPlanner(Map* map, Map::Cell* start, Map::Cell* goal, Config config)
+{
+	_config = config;
+
+	if (_config.cluster_size < 2)
+	{
+		_config.cluster_size = 2;
+	}
+
+	_map = map;
+	_start = start;
+	_goal = goal;
+	_last = _start;
+	_temp = NULL;
+
+	_expansions = 0;
+	_km = 0;
+
+	_open_list = new OL();
+
+	unsigned int size = _config.cluster_size;
+	_clusters_x = (_map->cols() + size - 1) / size;
+	_clusters_y = (_map->rows() + size - 1) / size;
+
+	unsigned int n = _clusters_x * _clusters_y;
+
+	_borders.resize(n * 2);
+	_built.assign(n, false);
+	_changed.resize(n);
+	_clusters.resize(n);
+	_dirty.assign(n, false);
+	_path_affected = true;
+
+	// Goal is the root of the search
+	Node* g = _node(_goal);
+	g->rhs = 0;
+
+	// Entrances are cheap, intra edges are built on demand
+	for (unsigned int b = 0; b < n * 2; b++)
+	{
+		_scan(b);
+	}
+
+	vector<Map::Cell*> added;
+
+	for (unsigned int c = 0; c < n; c++)
+	{
+		_collect(c, added);
+	}
+
+	_open_list->insert(_goal, pair<double,double>(_h(_start, _goal), 0), &g->pos);
+}
+
+/**
+ * Deconstructor.
+ */
+HierarchicalPlanner::~HierarchicalPlanner()
+{
+	delete _open_list;
+}
+
+/**
+ * Determines if a change since the last replan() touches the path.
+ *
+ * @return  bool
+ */
+bool HierarchicalPlanner::affected()
+{
+	return _path_affected || _path.empty();
+}
+
+/**
+ * Gets the number of abstract nodes expanded by all replans (refreshing a
+ * stale key doesn't count).
+ *
+ * @return  unsigned long
+ */
+unsigned long HierarchicalPlanner::expansions()
+{
+	return _expansions;
+}
+
+/**
+ * Gets the goal.
+ *
+ * @return  Map::Cell*
+ */
+Map::Cell* HierarchicalPlanner::goal()
+{
+	return _goal;
+}
+
+/**
+ * Gets the cost of a cell as this planner knows it.
+ *
+ * @param   Map::Cell*   cell
+ * @return  double       cost
+ */
+double HierarchicalPlanner::cost(Map::Cell* u)
+{
+	return _cell_cost(u);
+}
+
+/**
+ * Gets the next cell on the path.
+ *
+ * @return  Map::Cell*   next cell (NULL at the goal, without a path, or when
+ *                       start left the path and needs a replan)
+ */
+Map::Cell* HierarchicalPlanner::next_step()
+{
+	if (_start == _goal)
+		return NULL;
+
+	if (_segment.empty() && ! _refine())
+		return NULL;
+
+	return _segment.front();
+}
+
+/**
+ * Returns the abstract path (start, entrances, goal).
+ *
+ * @return  list<Map::Cell*>   waypoints
+ */
+const list<Map::Cell*>& HierarchicalPlanner::path()
+{
+	_path.clear();
+
+	Map::Cell* u = _start;
+	unsigned int steps = (unsigned int) _nodes.size();
+
+	while (u != NULL)
+	{
+		NH::iterator i = _nodes.find(u);
+
+		if (i == _nodes.end() || i->second.g == Math::INF || steps-- == 0)
+			break;
+
+		_path.push_back(u);
+
+		if (u == _goal)
+			return _path;
+
+		u = i->second.succ;
+	}
+
+	// Successor chain broke off, there is no usable path
+	_path.clear();
+
+	return _path;
+}
+
+/**
+ * Replans the path.
+ *
+ * @return  bool   solution found
+ */
+bool HierarchicalPlanner::replan()
+{
+	_segment.clear();
+
+	_prepare();
+
+	bool result = _compute() && _nodes.find(_start)->second.g != Math::INF;
+
+	// Later changes are checked against this path
+	path();
+	_path_affected = false;
+
+	return result;
+}
+
+/**
+ * Gets/Sets start.
+ *
+ * @param   Map::Cell* [optional]   new start
+ * @return  Map::Cell*              start
+ */
+Map::Cell* HierarchicalPlanner::start(Map::Cell* u)
+{
+	if (u == NULL)
+		return _start;
+
+	// Moving along the refined hop keeps the rest of it
+	if ( ! _segment.empty() && _segment.front() == u)
+	{
+		_segment.pop_front();
+	}
+	else
+	{
+		_segment.clear();
+	}
+
+	_start = u;
+
+	return _start;
+}
+
+/**
+ * Determines if the last replan() stopped early (never, there is no search
+ * budget).
+ *
+ * @return  bool
+ */
+bool HierarchicalPlanner::suspended()
+{
+	return false;
+}
+
+/**
+ * Update map.
+ *
+ * @param   Map::Cell*   cell to update
+ * @param   double       new cost of the cell
+ * @return  void
+ */
+void HierarchicalPlanner::update(Map::Cell* u, double cost)
+{
+	double old = _cell_cost(u);
+
+	if (u == _goal || old == cost)
+		return;
+
+	bool cheaper = cost < old;
+
+	if ( ! _path_affected && _touches(u, cheaper))
+	{
+		_path_affected = true;
+	}
+
+	_costs[u] = cost;
+
+	unsigned int c = _cluster(u);
+
+	if ( ! _dirty[c])
+	{
+		_dirty[c] = true;
+		_dirty_list.push_back(c);
+	}
+
+	_changed[c].push_back(pair<Map::Cell*,bool>(u, cheaper));
+}
+
+/**
+ * Update map with many cells at once.
+ *
+ * @param   vector<pair<Map::Cell*,double> >   cells to update and their new costs
+ * @return  void
+ */
+void HierarchicalPlanner::update_batch(const vector<pair<Map::Cell*,double> >& changes)
+{
+	for (unsigned int i = 0; i < changes.size(); i++)
+	{
+		update(changes[i].first, changes[i].second);
+	}
+}
+
+/**
+ * Builds the intra edges of a cluster.
+ *
+ * @param   unsigned int   cluster
+ * @return  void
+ */
+void HierarchicalPlanner::_build(unsigned int c)
+{
+	if (_built[c])
+		return;
+
+	_built[c] = true;
+
+	unsigned int size = _config.cluster_size;
+	vector<Map::Cell*>& nodes = _clusters[c];
+
+	Window window;
+	_window(c % _clusters_x, c / _clusters_x, c % _clusters_x, c / _clusters_x, window);
+
+	// Edges go both ways, so each node only searches for the ones after it
+	for (unsigned int i = 0; i + 1 < nodes.size(); i++)
+	{
+		vector<Map::Cell*> targets(nodes.begin() + i + 1, nodes.end());
+
+		if ( ! window.uniform)
+		{
+			_link(window, nodes[i], targets);
+			continue;
+		}
+
+		// Open ground of one cost, the shortest path runs diagonally first
+		for (unsigned int j = 0; j < targets.size(); j++)
+		{
+			int x = nodes[i]->x();
+			int y = nodes[i]->y();
+			int tx = targets[j]->x();
+			int ty = targets[j]->y();
+			unsigned int dx = abs(tx - x);
+			unsigned int dy = abs(ty - y);
+			unsigned int diagonal = (dx < dy) ? dx : dy;
+			vector<bool> used(size * size, false);
+
+			while (true)
+			{
+				used[(y % size) * size + x % size] = true;
+
+				if (x == tx && y == ty)
+					break;
+
+				x += (tx > x) ? 1 : ((tx < x) ? -1 : 0);
+				y += (ty > y) ? 1 : ((ty < y) ? -1 : 0);
+			}
+
+			_edge(nodes[i], targets[j], window.costs[0] * (Math::SQRT2 * diagonal + (dx + dy - 2 * diagonal)), used);
+		}
+	}
+}
+
+/**
+ * Gets the cost of a cell.
+ *
+ * @param   Map::Cell*   cell
+ * @return  double       cost
+ */
+double HierarchicalPlanner::_cell_cost(Map::Cell* u)
+{
+	if ( ! _costs.empty())
+	{
+		CC::iterator i = _costs.find(u);
+
+		if (i != _costs.end())
+			return i->second;
+	}
+
+	return _map->cost(u);
+}
+
+/**
+ * Finds the cheapest crossing in a stretch of a cluster side.
+ *
+ * @param   unsigned int   side (2 * cluster + 0 right, + 1 bottom)
+ * @param   unsigned int   first position along the side
+ * @param   unsigned int   position past the end
+ * @param   unsigned int   position taken on a tie (the nearest to it wins)
+ * @return  unsigned int   position
+ */
+unsigned int HierarchicalPlanner::_cheapest(unsigned int b, unsigned int first, unsigned int last, unsigned int prefer)
+{
+	unsigned int size = _config.cluster_size;
+	unsigned int c = b / 2;
+	bool right = (b % 2 == 0);
+	unsigned int edge = right ? (c % _clusters_x + 1) * size - 1 : (c / _clusters_x + 1) * size - 1;
+
+	unsigned int best = prefer;
+	double best_cost = Math::INF;
+	unsigned int best_distance = 0;
+
+	for (unsigned int i = first; i < last; i++)
+	{
+		Map::Cell* u = right ? (*_map)(i, edge) : (*_map)(edge, i);
+		Map::Cell* v = right ? (*_map)(i, edge + 1) : (*_map)(edge + 1, i);
+
+		double cost = _cost(u, v);
+		unsigned int distance = (i > prefer) ? i - prefer : prefer - i;
+
+		if (cost < best_cost || (cost == best_cost && distance < best_distance))
+		{
+			best = i;
+			best_cost = cost;
+			best_distance = distance;
+		}
+	}
+
+	return best;
+}
+
+/**
+ * Gets the cluster of a cell.
+ *
+ * @param   Map::Cell*     cell
+ * @return  unsigned int   cluster
+ */
+unsigned int HierarchicalPlanner::_cluster(Map::Cell* u)
+{
+	return (u->y() / _config.cluster_size) * _clusters_x + u->x() / _config.cluster_size;
+}
+
+/**
+ * Collects the abstract nodes of a cluster from its sides.
+ *
+ * @param   unsigned int          cluster
+ * @param   vector<Map::Cell*>&   nodes that opened (sorted)
+ * @return  void
+ */
+void HierarchicalPlanner::_collect(unsigned int c, vector<Map::Cell*>& added)
+{
+	vector<Map::Cell*> nodes;
+
+	// Own right and bottom sides
+	for (unsigned int i = 0; i < _borders[c * 2].size(); i++)
+	{
+		nodes.push_back(_borders[c * 2][i].first);
+	}
+
+	for (unsigned int i = 0; i < _borders[c * 2 + 1].size(); i++)
+	{
+		nodes.push_back(_borders[c * 2 + 1][i].first);
+	}
+
+	// Left neighbor's right side and top neighbor's bottom side
+	if (c % _clusters_x > 0)
+	{
+		vector<Transition>& t = _borders[(c - 1) * 2];
+
+		for (unsigned int i = 0; i < t.size(); i++)
+		{
+			nodes.push_back(t[i].second);
+		}
+	}
+
+	if (c >= _clusters_x)
+	{
+		vector<Transition>& t = _borders[(c - _clusters_x) * 2 + 1];
+
+		for (unsigned int i = 0; i < t.size(); i++)
+		{
+			nodes.push_back(t[i].second);
+		}
+	}
+
+	if (_cluster(_goal) == c)
+	{
+		nodes.push_back(_goal);
+	}
+
+	sort(nodes.begin(), nodes.end());
+	nodes.erase(unique(nodes.begin(), nodes.end()), nodes.end());
+
+	// Entrances that closed, the intra edges of the others lose them
+	vector<Map::Cell*>& old = _clusters[c];
+
+	for (unsigned int i = 0; i < old.size(); i++)
+	{
+		if (binary_search(nodes.begin(), nodes.end(), old[i]))
+			continue;
+
+		for (unsigned int j = 0; _built[c] && j < nodes.size(); j++)
+		{
+			_edge(nodes[j], old[i], Math::INF);
+		}
+
+		_remove(old[i]);
+	}
+
+	added.clear();
+
+	for (unsigned int i = 0; i < nodes.size(); i++)
+	{
+		if ( ! binary_search(old.begin(), old.end(), nodes[i]))
+		{
+			added.push_back(nodes[i]);
+		}
+	}
+
+	_clusters[c].swap(nodes);
+}
+
+/**
+ * Computes shortest path on the abstract graph.
+ *
+ * @return  bool   successful
+ */
+bool HierarchicalPlanner::_compute()
+{
+	Planner::KeyCompare key_compare;
+
+	int attempts = 0;
+
+	Map::Cell* u;
+	Node* n;
+	Node* m;
+	pair<double,double> k_old;
+	pair<double,double> k_new;
+	double g_old;
+
+	Node* s = &_nodes.find(_start)->second;
+
+	while (( ! _open_list->empty() && key_compare(_open_list->top_key(), _k(_start))) || ! Math::equals(s->rhs, s->g))
+	{
+		// Reached max steps, quit
+		if (++attempts > HierarchicalPlanner::MAX_STEPS)
+			return false;
+
+		// Start is inconsistent but nothing is left to expand
+		if (_open_list->empty())
+			return false;
+
+		u = _open_list->top();
+		k_old = _open_list->top_key();
+		k_new = _k(u);
+
+		n = &_nodes.find(u)->second;
+
+		// Expanding a node needs its cluster's intra edges
+		_build(_cluster(u));
+
+		// A stale key is only refreshed, that is no expansion
+		if (key_compare(k_old, k_new))
+		{
+			_open_list->update(&n->pos, k_new);
+			continue;
+		}
+
+		_expansions++;
+
+		if (Math::greater(n->g, n->rhs))
+		{
+			n->g = n->rhs;
+			_open_list->remove(&n->pos);
+
+			// The start node's edges only lead out of it
+			for (unsigned int i = 0; u != _temp && i < n->edges.size(); i++)
+			{
+				Edge& e = n->edges[i];
+				m = &_nodes.find(e.to)->second;
+
+				if (e.to != _goal && e.cost + n->g < m->rhs)
+				{
+					m->rhs = e.cost + n->g;
+					m->succ = u;
+				}
+
+				_update(e.to);
+			}
+		}
+		else
+		{
+			g_old = n->g;
+			n->g = Math::INF;
+
+			if (u != _goal)
+			{
+				pair<Map::Cell*,double> succ = _min_succ(u);
+				n->succ = succ.first;
+				n->rhs = succ.second;
+			}
+
+			_update(u);
+
+			for (unsigned int i = 0; u != _temp && i < n->edges.size(); i++)
+			{
+				Edge& e = n->edges[i];
+				m = &_nodes.find(e.to)->second;
+
+				if (e.to != _goal && Math::equals(m->rhs, e.cost + g_old))
+				{
+					pair<Map::Cell*,double> succ = _min_succ(e.to);
+					m->succ = succ.first;
+					m->rhs = succ.second;
+				}
+
+				_update(e.to);
+			}
+		}
+
+		// The start node is nobody's successor, so tell it directly
+		if (_temp != NULL && u != _temp)
+		{
+			_notify(u);
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Calculates the cost from one cell to a neighboring cell.
+ *
+ * @param   Map::Cell*   cell a
+ * @param   Map::Cell*   cell b
+ * @return  double       cost between a and b
+ */
+double HierarchicalPlanner::_cost(Map::Cell* a, Map::Cell* b)
+{
+	double cost_a = _cell_cost(a);
+	double cost_b = _cell_cost(b);
+
+	if (cost_a == Map::Cell::COST_UNWALKABLE || cost_b == Map::Cell::COST_UNWALKABLE)
+		return Math::INF;
+
+	unsigned int dx = abs((int) a->x() - (int) b->x());
+	unsigned int dy = abs((int) a->y() - (int) b->y());
+	double scale = 1.0;
+
+	if ((dx + dy) > 1)
+	{
+		scale = Math::SQRT2;
+	}
+
+	return scale * ((cost_a + cost_b) / 2);
+}
+
+/**
+ * Sets the intra edges between two nodes (both ways).
+ *
+ * @param   Map::Cell*     node a
+ * @param   Map::Cell*     node b
+ * @param   double         cost (Math::INF removes the edges)
+ * @param   vector<bool>&  cells on the path (by local index)
+ * @return  void
+ */
+void HierarchicalPlanner::_edge(Map::Cell* a, Map::Cell* b, double cost, const vector<bool>& used)
+{
+	Map::Cell* ends[2] = { a, b };
+
+	for (unsigned int i = 0; i < 2; i++)
+	{
+		vector<Edge>& edges = _nodes.find(ends[i])->second.edges;
+		unsigned int j = 0;
+
+		while (j < edges.size() && (edges[j].inter || edges[j].to != ends[1 - i]))
+		{
+			j++;
+		}
+
+		if (cost == Math::INF)
+		{
+			if (j < edges.size())
+			{
+				edges.erase(edges.begin() + j);
+			}
+
+			continue;
+		}
+
+		if (j == edges.size())
+		{
+			Edge e;
+			e.to = ends[1 - i];
+			e.inter = false;
+			edges.push_back(e);
+		}
+
+		edges[j].cost = cost;
+		edges[j].used = used;
+	}
+}
+
+/**
+ * Calculates heuristic between two cells (octile distance).
+ *
+ * @param   Map::Cell*   cell a
+ * @param   Map::Cell*   cell b
+ * @return  double       heuristic value
+ */
+double HierarchicalPlanner::_h(Map::Cell* a, Map::Cell* b)
+{
+	unsigned int dx = abs((int) a->x() - (int) b->x());
+	unsigned int dy = abs((int) a->y() - (int) b->y());
+
+	// Abstract edges are exact path costs, so keep the bound strictly below them
+	return Cost<double>::bound(Neighborhood8::h<double>(dx, dy));
+}
+
+/**
+ * Gets the intra edge from one node to another.
+ *
+ * @param   Map::Cell*   node a
+ * @param   Map::Cell*   node b
+ * @return  Edge*        edge (NULL without one)
+ */
+HierarchicalPlanner::Edge* HierarchicalPlanner::_intra(Map::Cell* a, Map::Cell* b)
+{
+	vector<Edge>& edges = _nodes.find(a)->second.edges;
+
+	for (unsigned int i = 0; i < edges.size(); i++)
+	{
+		if ( ! edges[i].inter && edges[i].to == b)
+			return &edges[i];
+	}
+
+	return NULL;
+}
+
+/**
+ * Calculates key value for a node.
+ *
+ * @param   Map::Cell*            node
+ * @return  pair<double,double>   key value
+ */
+pair<double,double> HierarchicalPlanner::_k(Map::Cell* u)
+{
+	Node* n = &_nodes.find(u)->second;
+	double min = (n->g < n->rhs) ? n->g : n->rhs;
+	return pair<double,double>((min + _h(_start, u) + _km), min);
+}
+
+/**
+ * Connects a node to other nodes of its cluster by shortest paths, and keeps
+ * the cells of each path on its edge.
+ *
+ * @param   Window&               cluster costs
+ * @param   Map::Cell*            node
+ * @param   vector<Map::Cell*>&   other nodes
+ * @return  void
+ */
+void HierarchicalPlanner::_link(const Window& window, Map::Cell* u, const vector<Map::Cell*>& targets)
+{
+	vector<double> dist;
+	vector<unsigned int> parent;
+	_search(window, u, targets, dist, parent);
+
+	unsigned int size = _config.cluster_size;
+	unsigned int source = (u->y() - window.y) * window.w + (u->x() - window.x);
+
+	for (unsigned int i = 0; i < targets.size(); i++)
+	{
+		unsigned int j = (targets[i]->y() - window.y) * window.w + (targets[i]->x() - window.x);
+
+		if (dist[j] == Math::INF)
+		{
+			_edge(u, targets[i], Math::INF);
+			continue;
+		}
+
+		// The window starts at the cluster's corner, so rows map straight to local indices
+		vector<bool> used(size * size, false);
+
+		for (unsigned int k = j; ; k = parent[k])
+		{
+			used[(k / window.w) * size + k % window.w] = true;
+
+			if (k == source)
+				break;
+		}
+
+		_edge(u, targets[i], dist[j], used);
+	}
+}
+
+/**
+ * Gets the index of a cell inside its cluster.
+ *
+ * @param   Map::Cell*     cell
+ * @return  unsigned int   index
+ */
+unsigned int HierarchicalPlanner::_local(Map::Cell* u)
+{
+	unsigned int size = _config.cluster_size;
+	return (u->y() % size) * size + u->x() % size;
+}
+
+/**
+ * Finds the minimum successor node.
+ *
+ * @param   Map::Cell*                node
+ * @return  pair<Map::Cell*,double>   successor and rhs value
+ */
+pair<Map::Cell*,double> HierarchicalPlanner::_min_succ(Map::Cell* u)
+{
+	vector<Edge>& edges = _nodes.find(u)->second.edges;
+
+	Map::Cell* min_cell = NULL;
+	double min_cost = Math::INF;
+
+	for (unsigned int i = 0; i < edges.size(); i++)
+	{
+		double g = _nodes.find(edges[i].to)->second.g;
+
+		if (g == Math::INF)
+			continue;
+
+		if (edges[i].cost + g < min_cost)
+		{
+			min_cell = edges[i].to;
+			min_cost = edges[i].cost + g;
+		}
+	}
+
+	return pair<Map::Cell*,double>(min_cell, min_cost);
+}
+
+/**
+ * Gets a node, adding it if needed.
+ *
+ * @param   Map::Cell*   cell
+ * @return  Node*
+ */
+HierarchicalPlanner::Node* HierarchicalPlanner::_node(Map::Cell* u)
+{
+	NH::iterator i = _nodes.find(u);
+
+	if (i != _nodes.end())
+		return &i->second;
+
+	Node* n = &_nodes[u];
+	n->g = Math::INF;
+	n->rhs = Math::INF;
+	n->pos = OL::NONE;
+	n->succ = NULL;
+
+	return n;
+}
+
+/**
+ * Re-evaluates the start node after one of its successors changed.
+ *
+ * @param   Map::Cell*   expanded node
+ * @return  void
+ */
+void HierarchicalPlanner::_notify(Map::Cell* u)
+{
+	Node* t = &_nodes.find(_temp)->second;
+
+	for (unsigned int i = 0; i < t->edges.size(); i++)
+	{
+		if (t->edges[i].to == u)
+		{
+			pair<Map::Cell*,double> succ = _min_succ(_temp);
+			t->succ = succ.first;
+			t->rhs = succ.second;
+
+			_update(_temp);
+			return;
+		}
+	}
+}
+
+/**
+ * Brings dirty clusters and the start node up to date.
+ *
+ * @return  void
+ */
+void HierarchicalPlanner::_prepare()
+{
+	// Update km
+	if (_start != _last)
+	{
+		_km += _h(_last, _start);
+		_last = _start;
+	}
+
+	// The start node is rebuilt below
+	if (_temp != NULL)
+	{
+		_remove(_temp);
+		_temp = NULL;
+	}
+
+	if ( ! _dirty_list.empty())
+	{
+		unsigned int size = _config.cluster_size;
+		vector<unsigned int> sides;
+		vector<unsigned int> touched;
+
+		for (unsigned int i = 0; i < _dirty_list.size(); i++)
+		{
+			unsigned int c = _dirty_list[i];
+			unsigned int cx = c % _clusters_x;
+			unsigned int cy = c / _clusters_x;
+			vector<pair<Map::Cell*,bool> >& changed = _changed[c];
+
+			_dirty[c] = false;
+			touched.push_back(c);
+
+			// Only cells on a side decide its entrances and inter edges
+			for (unsigned int j = 0; j < changed.size(); j++)
+			{
+				unsigned int x = changed[j].first->x() % size;
+				unsigned int y = changed[j].first->y() % size;
+
+				if (x == size - 1 && cx + 1 < _clusters_x)
+				{
+					sides.push_back(c * 2);
+					touched.push_back(c + 1);
+				}
+
+				if (x == 0 && cx > 0)
+				{
+					sides.push_back((c - 1) * 2);
+					touched.push_back(c - 1);
+				}
+
+				if (y == size - 1 && cy + 1 < _clusters_y)
+				{
+					sides.push_back(c * 2 + 1);
+					touched.push_back(c + _clusters_x);
+				}
+
+				if (y == 0 && cy > 0)
+				{
+					sides.push_back((c - _clusters_x) * 2 + 1);
+					touched.push_back(c - _clusters_x);
+				}
+			}
+		}
+
+		sort(sides.begin(), sides.end());
+		sides.erase(unique(sides.begin(), sides.end()), sides.end());
+
+		sort(touched.begin(), touched.end());
+		touched.erase(unique(touched.begin(), touched.end()), touched.end());
+
+		for (unsigned int i = 0; i < sides.size(); i++)
+		{
+			_unscan(sides[i]);
+			_scan(sides[i]);
+		}
+
+		// Every node whose edges may have changed
+		vector<Map::Cell*> affected;
+		vector<Map::Cell*> added;
+
+		for (unsigned int i = 0; i < touched.size(); i++)
+		{
+			unsigned int c = touched[i];
+
+			_collect(c, added);
+
+			if (_built[c])
+			{
+				_repair(c, added);
+			}
+
+			affected.insert(affected.end(), _clusters[c].begin(), _clusters[c].end());
+		}
+
+		for (unsigned int i = 0; i < _dirty_list.size(); i++)
+		{
+			_changed[_dirty_list[i]].clear();
+		}
+
+		_dirty_list.clear();
+
+		for (unsigned int i = 0; i < affected.size(); i++)
+		{
+			if (affected[i] != _goal)
+			{
+				Node* n = &_nodes.find(affected[i])->second;
+				pair<Map::Cell*,double> succ = _min_succ(affected[i]);
+				n->succ = succ.first;
+				n->rhs = succ.second;
+			}
+
+			_update(affected[i]);
+		}
+	}
+
+	// Start off the entrances, link it to its cluster's nodes
+	if (_nodes.find(_start) == _nodes.end())
+	{
+		Node* s = _node(_start);
+		_temp = _start;
+
+		unsigned int c = _cluster(_start);
+		vector<Map::Cell*>& nodes = _clusters[c];
+
+		Window window;
+		_window(c % _clusters_x, c / _clusters_x, c % _clusters_x, c / _clusters_x, window);
+
+		vector<double> dist;
+		vector<unsigned int> parent;
+		_search(window, _start, nodes, dist, parent);
+
+		for (unsigned int i = 0; i < nodes.size(); i++)
+		{
+			double d = dist[(nodes[i]->y() - window.y) * window.w + (nodes[i]->x() - window.x)];
+
+			if (d == Math::INF)
+				continue;
+
+			Edge e;
+			e.to = nodes[i];
+			e.cost = d;
+			e.inter = false;
+			s->edges.push_back(e);
+		}
+
+		pair<Map::Cell*,double> succ = _min_succ(_start);
+		s->succ = succ.first;
+		s->rhs = succ.second;
+
+		_update(_start);
+	}
+}
+
+/**
+ * Refines the path in the clusters around the start to cells.
+ *
+ * The target is the last node of the path in a cluster next to the start's
+ * (or the start's own), and the search may use every cluster between them,
+ * so the robot cuts across the entrances on the way.
+ *
+ * @return  bool   successful
+ */
+bool HierarchicalPlanner::_refine()
+{
+	NH::iterator i = _nodes.find(_start);
+
+	if (i == _nodes.end() || i->second.succ == NULL || i->second.g == Math::INF)
+		return false;
+
+	unsigned int c = _cluster(_start);
+	unsigned int cx = c % _clusters_x;
+	unsigned int cy = c / _clusters_x;
+	unsigned int x0 = cx, y0 = cy, x1 = cx, y1 = cy;
+
+	Map::Cell* target = NULL;
+	Map::Cell* w = i->second.succ;
+	unsigned int steps = (unsigned int) _nodes.size();
+
+	while (w != NULL && steps-- > 0)
+	{
+		unsigned int d = _cluster(w);
+		unsigned int dx = d % _clusters_x;
+		unsigned int dy = d / _clusters_x;
+
+		if (dx + 1 < cx || dx > cx + 1 || dy + 1 < cy || dy > cy + 1)
+			break;
+
+		target = w;
+		x0 = min(x0, dx);
+		y0 = min(y0, dy);
+		x1 = max(x1, dx);
+		y1 = max(y1, dy);
+
+		if (w == _goal)
+			break;
+
+		NH::iterator j = _nodes.find(w);
+
+		if (j == _nodes.end() || j->second.g == Math::INF)
+			break;
+
+		w = j->second.succ;
+	}
+
+	if (target == NULL)
+		return false;
+
+	Window window;
+	_window(x0, y0, x1, y1, window);
+
+	vector<double> dist;
+	vector<unsigned int> parent;
+	_search(window, _start, vector<Map::Cell*>(1, target), dist, parent);
+
+	unsigned int source = (_start->y() - window.y) * window.w + (_start->x() - window.x);
+	unsigned int k = (target->y() - window.y) * window.w + (target->x() - window.x);
+
+	if (dist[k] == Math::INF)
+		return false;
+
+	for (; k != source; k = parent[k])
+	{
+		_segment.push_front((*_map)(window.y + k / window.w, window.x + k % window.w));
+	}
+
+	return true;
+}
+
+/**
+ * Removes a node.
+ *
+ * @param   Map::Cell*   cell
+ * @return  void
+ */
+void HierarchicalPlanner::_remove(Map::Cell* u)
+{
+	NH::iterator i = _nodes.find(u);
+
+	if (i == _nodes.end())
+		return;
+
+	if (i->second.pos != OL::NONE)
+	{
+		_open_list->remove(&i->second.pos);
+	}
+
+	_nodes.erase(i);
+}
+
+/**
+ * Searches the intra edges of a cluster again where changes can have altered
+ * them, and links the nodes that opened.
+ *
+ * An edge is searched again when a cell of its path got more expensive, or
+ * when a cheaper cell could lie on a shorter path.
+ *
+ * @param   unsigned int          cluster
+ * @param   vector<Map::Cell*>&   nodes that opened (sorted)
+ * @return  void
+ */
+void HierarchicalPlanner::_repair(unsigned int c, const vector<Map::Cell*>& added)
+{
+	vector<Map::Cell*>& nodes = _clusters[c];
+	vector<pair<Map::Cell*,bool> >& changed = _changed[c];
+	unsigned int n = nodes.size();
+
+	// Pairs to search again, i < j at i * n + j
+	vector<bool> stale(n * n, false);
+	bool any = false;
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		bool opened = binary_search(added.begin(), added.end(), nodes[i]);
+
+		for (unsigned int j = i + 1; j < n; j++)
+		{
+			if (opened || binary_search(added.begin(), added.end(), nodes[j]))
+			{
+				stale[i * n + j] = true;
+				any = true;
+				continue;
+			}
+
+			Edge* e = _intra(nodes[i], nodes[j]);
+			double cost = (e == NULL) ? Math::INF : e->cost;
+
+			for (unsigned int k = 0; k < changed.size(); k++)
+			{
+				Map::Cell* u = changed[k].first;
+
+				if (changed[k].second ? _h(nodes[i], u) + _h(u, nodes[j]) < cost : e != NULL && e->used[_local(u)])
+				{
+					stale[i * n + j] = true;
+					any = true;
+					break;
+				}
+			}
+		}
+	}
+
+	if ( ! any)
+		return;
+
+	Window window;
+	_window(c % _clusters_x, c / _clusters_x, c % _clusters_x, c / _clusters_x, window);
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		vector<Map::Cell*> targets;
+
+		for (unsigned int j = i + 1; j < n; j++)
+		{
+			if (stale[i * n + j])
+			{
+				targets.push_back(nodes[j]);
+			}
+		}
+
+		if ( ! targets.empty())
+		{
+			_link(window, nodes[i], targets);
+		}
+	}
+}
+
+/**
+ * Finds the transitions on one cluster side.
+ *
+ * @param   unsigned int   side (2 * cluster + 0 right, + 1 bottom)
+ * @return  void
+ */
+void HierarchicalPlanner::_scan(unsigned int b)
+{
+	unsigned int size = _config.cluster_size;
+	unsigned int c = b / 2;
+	unsigned int cx = c % _clusters_x;
+	unsigned int cy = c / _clusters_x;
+	bool right = (b % 2 == 0);
+
+	// No neighbor on this side
+	if ((right && cx + 1 >= _clusters_x) || ( ! right && cy + 1 >= _clusters_y))
+		return;
+
+	unsigned int first = right ? cy * size : cx * size;
+	unsigned int limit = right ? _map->rows() : _map->cols();
+	unsigned int last = (first + size < limit) ? first + size : limit;
+	unsigned int edge = right ? (cx + 1) * size - 1 : (cy + 1) * size - 1;
+
+	vector<Transition>& transitions = _borders[b];
+	unsigned int run = first;
+
+	// Walk the side one past the end, so the last stretch gets closed
+	for (unsigned int i = first; i <= last; i++)
+	{
+		bool open = false;
+		Map::Cell* u = NULL;
+		Map::Cell* v = NULL;
+
+		if (i < last)
+		{
+			u = right ? (*_map)(i, edge) : (*_map)(edge, i);
+			v = right ? (*_map)(i, edge + 1) : (*_map)(edge + 1, i);
+			open = (_cell_cost(u) != Map::Cell::COST_UNWALKABLE && _cell_cost(v) != Map::Cell::COST_UNWALKABLE);
+		}
+
+		if (open)
+			continue;
+
+		// Close the stretch [run, i)
+		if (i > run)
+		{
+			unsigned int length = i - run;
+			unsigned int at[2] = { _cheapest(b, run, i, run + length / 2), 0 };
+			unsigned int count = 1;
+
+			// Long stretches get an entrance toward each end, both at the
+			// cheapest crossing of their half
+			if (length >= _config.entrance_split)
+			{
+				at[0] = _cheapest(b, run, run + length / 2, run);
+				at[1] = _cheapest(b, run + length / 2, i, i - 1);
+				count = 2;
+			}
+
+			for (unsigned int j = 0; j < count; j++)
+			{
+				Transition t;
+				t.first = right ? (*_map)(at[j], edge) : (*_map)(edge, at[j]);
+				t.second = right ? (*_map)(at[j], edge + 1) : (*_map)(edge + 1, at[j]);
+
+				double cost = _cost(t.first, t.second);
+
+				Edge e;
+				e.cost = cost;
+				e.inter = true;
+
+				e.to = t.second;
+				_node(t.first)->edges.push_back(e);
+
+				e.to = t.first;
+				_node(t.second)->edges.push_back(e);
+
+				transitions.push_back(t);
+			}
+		}
+
+		run = i + 1;
+	}
+}
+
+/**
+ * Searches shortest paths from a cell without leaving a window: Dijkstra
+ * until every target is settled, or A* with one target.
+ *
+ * @param   Window&               costs
+ * @param   Map::Cell*            source
+ * @param   vector<Map::Cell*>&   targets
+ * @param   vector<double>&       distances by window index
+ * @param   vector<unsigned int>& parents by window index
+ * @return  void
+ */
+void HierarchicalPlanner::_search(const Window& window, Map::Cell* source, const vector<Map::Cell*>& targets, vector<double>& dist, vector<unsigned int>& parent)
+{
+	// Queue items hold window indices, so the inner loop never asks a cell where it is
+	typedef pair<double, unsigned int> Item;
+
+	unsigned int w = window.w;
+	unsigned int h = window.h;
+	const vector<double>& costs = window.costs;
+
+	dist.assign(w * h, Math::INF);
+	parent.assign(w * h, 0);
+
+	vector<unsigned char> state(w * h, 0);
+	unsigned int left = 0;
+
+	// 1 marks a target that is not settled yet, 2 a settled cell
+	for (unsigned int i = 0; i < targets.size(); i++)
+	{
+		unsigned int j = (targets[i]->y() - window.y) * w + (targets[i]->x() - window.x);
+
+		if (state[j] == 0)
+		{
+			state[j] = 1;
+			left++;
+		}
+	}
+
+	// One target guides the search, the octile distance never overestimates
+	bool guided = (targets.size() == 1);
+	unsigned int gx = guided ? targets[0]->x() - window.x : 0;
+	unsigned int gy = guided ? targets[0]->y() - window.y : 0;
+
+	priority_queue<Item, vector<Item>, greater<Item> > queue;
+
+	unsigned int s = (source->y() - window.y) * w + (source->x() - window.x);
+	dist[s] = 0;
+	parent[s] = s;
+	queue.push(Item(0, s));
+
+	while ( ! queue.empty() && left > 0)
+	{
+		unsigned int i = queue.top().second;
+		queue.pop();
+
+		if (state[i] == 2)
+			continue;
+
+		if (state[i] == 1)
+		{
+			left--;
+		}
+
+		state[i] = 2;
+
+		double cost_u = costs[i];
+
+		if (cost_u == Math::INF)
+			continue;
+
+		unsigned int ux = i % w;
+		unsigned int uy = i / w;
+
+		for (unsigned int k = 0; k < Neighborhood8::SIZE; k++)
+		{
+			// Negative offsets wrap around and fail the bounds check
+			unsigned int vx = ux + Neighborhood8::dx(k);
+			unsigned int vy = uy + Neighborhood8::dy(k);
+
+			if (vx >= w || vy >= h)
+				continue;
+
+			unsigned int j = vy * w + vx;
+
+			if (state[j] == 2 || costs[j] == Math::INF)
+				continue;
+
+			double cost = (cost_u + costs[j]) / 2;
+
+			if (vx != ux && vy != uy)
+			{
+				cost *= Math::SQRT2;
+			}
+
+			double d = dist[i] + cost;
+
+			if (d < dist[j])
+			{
+				dist[j] = d;
+				parent[j] = i;
+
+				double f = d;
+
+				if (guided)
+				{
+					unsigned int dx = (vx > gx) ? vx - gx : gx - vx;
+					unsigned int dy = (vy > gy) ? vy - gy : gy - vy;
+					f += Neighborhood8::h<double>(dx, dy);
+				}
+
+				queue.push(Item(f, j));
+			}
+		}
+	}
+}
+
+/**
+ * Determines if a change can alter the refined hop or an abstract edge on
+ * the path.
+ *
+ * A cheaper cell only matters where a path through it could be shorter than
+ * the edge, a more expensive one only on the cells of the edge's path.
+ *
+ * @param   Map::Cell*   changed cell
+ * @param   bool         got cheaper
+ * @return  bool
+ */
+bool HierarchicalPlanner::_touches(Map::Cell* u, bool cheaper)
+{
+	for (list<Map::Cell*>::iterator i = _segment.begin(); i != _segment.end(); ++i)
+	{
+		if (*i == u)
+		{
+			_segment.clear();
+			return true;
+		}
+	}
+
+	if (_path.empty())
+		return true;
+
+	unsigned int c = _cluster(u);
+	list<Map::Cell*>::iterator a = _path.begin();
+	list<Map::Cell*>::iterator b = a;
+
+	for (++b; b != _path.end(); ++a, ++b)
+	{
+		if (*a == u || *b == u)
+			return true;
+
+		// Inter edges only depend on their ends
+		if (_cluster(*a) != c || _cluster(*b) != c)
+			continue;
+
+		Edge* e = _intra(*a, *b);
+
+		if (e == NULL)
+			return true;
+
+		if (cheaper)
+		{
+			if (_h(*a, u) + _h(u, *b) < e->cost)
+				return true;
+
+			continue;
+		}
+
+		// The start node keeps no paths, its hop is the refined one
+		if (e->used.empty() ? *a != _temp : e->used[_local(u)])
+			return true;
+	}
+
+	return false;
+}
+
+/**
+ * Removes the transitions on one cluster side.
+ *
+ * @param   unsigned int   side
+ * @return  void
+ */
+void HierarchicalPlanner::_unscan(unsigned int b)
+{
+	vector<Transition>& transitions = _borders[b];
+
+	for (unsigned int i = 0; i < transitions.size(); i++)
+	{
+		Map::Cell* ends[2] = { transitions[i].first, transitions[i].second };
+
+		for (unsigned int j = 0; j < 2; j++)
+		{
+			vector<Edge>& edges = _nodes.find(ends[j])->second.edges;
+
+			for (unsigned int k = 0; k < edges.size(); k++)
+			{
+				if (edges[k].inter && edges[k].to == ends[1 - j])
+				{
+					edges.erase(edges.begin() + k);
+					break;
+				}
+			}
+		}
+	}
+
+	transitions.clear();
+}
+
+/**
+ * Updates a node.
+ *
+ * @param   Map::Cell*   node to update
+ * @return  void
+ */
+void HierarchicalPlanner::_update(Map::Cell* u)
+{
+	Node* n = &_nodes.find(u)->second;
+
+	bool diff = n->g != n->rhs;
+	bool exists = (n->pos != OL::NONE);
+
+	if (diff && exists)
+	{
+		_open_list->update(&n->pos, _k(u));
+	}
+	else if (diff && ! exists)
+	{
+		_open_list->insert(u, _k(u), &n->pos);
+	}
+	else if ( ! diff && exists)
+	{
+		_open_list->remove(&n->pos);
+	}
+}
+
+/**
+ * Copies the cell costs of a rectangle of clusters.
+ *
+ * @param   unsigned int   left and top cluster column and row
+ * @param   unsigned int   right and bottom cluster column and row
+ * @param   Window&        window
+ * @return  void
+ */
+void HierarchicalPlanner::_window(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1, Window& window)
+{
+	unsigned int size = _config.cluster_size;
+
+	window.x = x0 * size;
+	window.y = y0 * size;
+	window.w = min((x1 + 1) * size, _map->cols()) - window.x;
+	window.h = min((y1 + 1) * size, _map->rows()) - window.y;
+	window.costs.resize(window.w * window.h);
+	window.uniform = true;
+
+	double first = _cell_cost((*_map)(window.y, window.x));
+
+	for (unsigned int i = 0; i < window.h; i++)
+	{
+		for (unsigned int j = 0; j < window.w; j++)
+		{
+			double cost = _cell_cost((*_map)(window.y + i, window.x + j));
+
+			if (cost != first || cost == Map::Cell::COST_UNWALKABLE)
+			{
+				window.uniform = false;
+			}
+
+			window.costs[i * window.w + j] = (cost == Map::Cell::COST_UNWALKABLE) ? Math::INF : cost;
+		}
+	}
+}
@@ -0,0 +1,637 @@
+/**
+ * Hierarchical Planner.
+ *
+ * Based on "Near Optimal Hierarchical Path-Finding" by Adi Botea, Martin Muller
+ * and Jonathan Schaeffer, with D* Lite (see Planner) as the abstract search.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#ifndef DSTARLITE_HIERARCHICAL_PLANNER_H
+#define DSTARLITE_HIERARCHICAL_PLANNER_H
+
+#include <list>
+#include <vector>
+#ifdef WIN32
+	#include <unordered_map>
+#else
+	#include <tr1/unordered_map>
+#endif
+#include "heap.h"
+#include "map.h"
+#include "math.h"
+#include "planner.h"
+
+using namespace std;
+using namespace DStarLite;
+
+namespace DStarLite
+{
+	/**
+	 * Planner for very large maps.
+	 *
+	 * The map is cut into square clusters. Every stretch of walkable cells
+	 * along a shared cluster side gets one or two entrances at its cheapest
+	 * crossings, and the entrance cells are the nodes of an abstract graph:
+	 * inter edges cross a side, intra edges are shortest paths inside one
+	 * cluster. D* Lite runs on that graph, and only the hop in front of the
+	 * robot is refined to cells.
+	 *
+	 * Intra edges are built the first time the search expands a node of the
+	 * cluster. A cost change only rescans the cluster sides it lies on and
+	 * searches again for the intra edges whose paths it can change, and only
+	 * one on the abstract path or the refined hop makes affected() true. Costs
+	 * are 8-connected doubles, the same as Planner. The clusters are cut
+	 * once, so the map must not grow.
+	 *
+	 * Refinement smooths the path: it searches the clusters around the robot
+	 * for the last node of the path among them, so the robot cuts across
+	 * the entrances in between. Paths still have no optimality bound, they
+	 * only come close to it inside that window (see README).
+	 */
+	class HierarchicalPlanner
+	{
+		public:
+
+			/**
+			 * Config class.
+			 */
+			class Config
+			{
+				public:
+
+					/**
+					 * @var  unsigned int  cluster width and height in cells
+					 */
+					unsigned int cluster_size;
+
+					/**
+					 * @var  unsigned int  stretches at least this long get an entrance at each end
+					 */
+					unsigned int entrance_split;
+
+					/**
+					 * Constructor.
+					 */
+					Config();
+			};
+
+			/*
+			 * @var  static const double  max steps before assuming no solution possible
+			 */
+			static const double MAX_STEPS;
+
+			/**
+			 * Constructor.
+			 *
+			 * @param  Map*         map
+			 * @param  Map::Cell*   start cell
+			 * @param  Map::Cell*   goal cell
+			 * @param  Config       config options
+			 */
+			HierarchicalPlanner(Map* map, Map::Cell* start, Map::Cell* goal, Config config = Config());
+
+			/**
+			 * Deconstructor.
+			 */
+			~HierarchicalPlanner();
+
+			/**
+			 * Determines if a change since the last replan() touches the path: a
+			 * cell of the refined hop, or one that can change an abstract edge on
+			 * the path. Other changes wait for the next replan().
+			 *
+			 * @return  bool
+			 */
+			bool affected();
+
+			/**
+			 * Gets the cost of a cell as this planner knows it (see Planner::cost()).
+			 *
+			 * @param   Map::Cell*   cell
+			 * @return  double       cost
+			 */
+			double cost(Map::Cell* u);
+
+			/**
+			 * Gets the number of abstract nodes expanded by all replans (refreshing
+			 * a stale key doesn't count).
+			 *
+			 * @return  unsigned long
+			 */
+			unsigned long expansions();
+
+			/**
+			 * Gets the goal.
+			 *
+			 * @return  Map::Cell*
+			 */
+			Map::Cell* goal();
+
+			/**
+			 * Gets the next cell on the path.
+			 *
+			 * Refines the next abstract hop to cells if needed.
+			 *
+			 * @return  Map::Cell*   next cell (NULL at the goal, without a path, or
+			 *                       when start left the path and needs a replan)
+			 */
+			Map::Cell* next_step();
+
+			/**
+			 * Returns the abstract path (start, entrances, goal).
+			 *
+			 * Consecutive cells are generally not neighbors, use next_step() to move.
+			 *
+			 * @return  list<Map::Cell*>   waypoints
+			 */
+			const list<Map::Cell*>& path();
+
+			/**
+			 * Replans the path.
+			 *
+			 * @return  bool   solution found
+			 */
+			bool replan();
+
+			/**
+			 * Gets/Sets start.
+			 *
+			 * @param   Map::Cell* [optional]   new start
+			 * @return  Map::Cell*              start
+			 */
+			Map::Cell* start(Map::Cell* u = NULL);
+
+			/**
+			 * Determines if the last replan() stopped early (never, there is no
+			 * search budget; see Planner::suspended()).
+			 *
+			 * @return  bool
+			 */
+			bool suspended();
+
+			/**
+			 * Update map.
+			 *
+			 * @param   Map::Cell*   cell to update
+			 * @param   double       new cost of the cell
+			 * @return  void
+			 */
+			void update(Map::Cell* u, double cost);
+
+			/**
+			 * Update map with many cells at once.
+			 *
+			 * Only marks the clusters holding the cells, they are rebuilt by the
+			 * next replan.
+			 *
+			 * @param   vector<pair<Map::Cell*,double> >   cells to update and their new costs
+			 * @return  void
+			 */
+			void update_batch(const vector<pair<Map::Cell*,double> >& changes);
+
+		protected:
+
+			/**
+			 * Abstract edge.
+			 */
+			struct Edge
+			{
+				/**
+				 * @var  Map::Cell*  other end
+				 */
+				Map::Cell* to;
+
+				/**
+				 * @var  double  cost
+				 */
+				double cost;
+
+				/**
+				 * @var  bool  crosses a cluster side
+				 */
+				bool inter;
+
+				/**
+				 * @var  vector<bool>  cells of the cluster on the intra path (by local
+				 *                     index, empty for the others)
+				 */
+				vector<bool> used;
+			};
+
+			/**
+			 * Abstract node (an entrance cell, the goal or the start).
+			 */
+			struct Node
+			{
+				/**
+				 * @var  vector<Edge>  edges
+				 */
+				vector<Edge> edges;
+
+				/**
+				 * @var  double  g value
+				 */
+				double g;
+
+				/**
+				 * @var  double  rhs value
+				 */
+				double rhs;
+
+				/**
+				 * @var  unsigned int  position in the open list
+				 */
+				unsigned int pos;
+
+				/**
+				 * @var  Map::Cell*  successor (NULL if none)
+				 */
+				Map::Cell* succ;
+			};
+
+			/**
+			 * Cell costs of a rectangle of clusters.
+			 */
+			struct Window
+			{
+				/**
+				 * @var  unsigned int  left and top cell
+				 */
+				unsigned int x;
+				unsigned int y;
+
+				/**
+				 * @var  unsigned int  width and height in cells
+				 */
+				unsigned int w;
+				unsigned int h;
+
+				/**
+				 * @var  vector<double>  costs row by row (Math::INF for walls)
+				 */
+				vector<double> costs;
+
+				/**
+				 * @var  bool  every cell is walkable and costs the same
+				 */
+				bool uniform;
+			};
+
+			/**
+			 * @var  typedef  abstract nodes by cell
+			 */
+			typedef tr1::unordered_map<Map::Cell*, Node, Map::Cell::Hash> NH;
+
+			/**
+			 * @var  typedef  cell costs that differ from the map
+			 */
+			typedef tr1::unordered_map<Map::Cell*, double, Map::Cell::Hash> CC;
+
+			/**
+			 * @var  typedef  transition (a pair of facing entrance cells)
+			 */
+			typedef pair<Map::Cell*, Map::Cell*> Transition;
+
+			/**
+			 * @var  typedef  open list
+			 */
+			typedef Heap<pair<double,double>, Planner::KeyCompare> OL;
+
+			/**
+			 * @var  vector<vector<Transition> >  transitions by side (2 * cluster + 0 right, + 1 bottom)
+			 */
+			vector<vector<Transition> > _borders;
+
+			/**
+			 * @var  vector<bool>  clusters with intra edges
+			 */
+			vector<bool> _built;
+
+			/**
+			 * @var  vector<vector<pair<Map::Cell*,bool> > >  cells changed since the last replan by cluster (true if cheaper)
+			 */
+			vector<vector<pair<Map::Cell*,bool> > > _changed;
+
+			/**
+			 * @var  vector<vector<Map::Cell*> >  abstract nodes by cluster
+			 */
+			vector<vector<Map::Cell*> > _clusters;
+
+			/**
+			 * @var  unsigned int  clusters across and down
+			 */
+			unsigned int _clusters_x;
+			unsigned int _clusters_y;
+
+			/**
+			 * @var  Config  planner config options
+			 */
+			Config _config;
+
+			/**
+			 * @var  CC  cell costs that differ from the map (the map is never written)
+			 */
+			CC _costs;
+
+			/**
+			 * @var  vector<bool>  clusters with cost changes
+			 */
+			vector<bool> _dirty;
+
+			/**
+			 * @var  vector<unsigned int>  clusters with cost changes (each once)
+			 */
+			vector<unsigned int> _dirty_list;
+
+			/**
+			 * @var  unsigned long  nodes expanded by all replans
+			 */
+			unsigned long _expansions;
+
+			/**
+			 * @var  double  accumulated heuristic value
+			 */
+			double _km;
+
+			/**
+			 * @var  Map*  map
+			 */
+			Map* _map;
+
+			/**
+			 * @var  NH  abstract nodes
+			 */
+			NH _nodes;
+
+			/**
+			 * @var  OL*  open list
+			 */
+			OL* _open_list;
+
+			/**
+			 * @var  list<Map::Cell*>  abstract path
+			 */
+			list<Map::Cell*> _path;
+
+			/**
+			 * @var  bool  a change touched the path (see affected())
+			 */
+			bool _path_affected;
+
+			/**
+			 * @var  list<Map::Cell*>  refined cells up to the next abstract node
+			 */
+			list<Map::Cell*> _segment;
+
+			/**
+			 * @var  Map::Cell*  start, goal, and last start tile
+			 */
+			Map::Cell* _start;
+			Map::Cell* _goal;
+			Map::Cell* _last;
+
+			/**
+			 * @var  Map::Cell*  start node that is not an entrance (NULL if none)
+			 */
+			Map::Cell* _temp;
+
+			/**
+			 * Builds the intra edges of a cluster.
+			 *
+			 * @param   unsigned int   cluster
+			 * @return  void
+			 */
+			void _build(unsigned int c);
+
+			/**
+			 * Gets the cost of a cell.
+			 *
+			 * @param   Map::Cell*   cell
+			 * @return  double       cost
+			 */
+			double _cell_cost(Map::Cell* u);
+
+			/**
+			 * Finds the cheapest crossing in a stretch of a cluster side.
+			 *
+			 * @param   unsigned int   side (2 * cluster + 0 right, + 1 bottom)
+			 * @param   unsigned int   first position along the side
+			 * @param   unsigned int   position past the end
+			 * @param   unsigned int   position taken on a tie (the nearest to it wins)
+			 * @return  unsigned int   position
+			 */
+			unsigned int _cheapest(unsigned int b, unsigned int first, unsigned int last, unsigned int prefer);
+
+			/**
+			 * Gets the cluster of a cell.
+			 *
+			 * @param   Map::Cell*     cell
+			 * @return  unsigned int   cluster
+			 */
+			unsigned int _cluster(Map::Cell* u);
+
+			/**
+			 * Collects the abstract nodes of a cluster from its sides.
+			 *
+			 * Nodes that closed are removed (with the intra edges leading to them).
+			 *
+			 * @param   unsigned int          cluster
+			 * @param   vector<Map::Cell*>&   nodes that opened (sorted)
+			 * @return  void
+			 */
+			void _collect(unsigned int c, vector<Map::Cell*>& added);
+
+			/**
+			 * Computes shortest path on the abstract graph.
+			 *
+			 * @return  bool   successful
+			 */
+			bool _compute();
+
+			/**
+			 * Calculates the cost from one cell to a neighboring cell.
+			 *
+			 * @param   Map::Cell*   cell a
+			 * @param   Map::Cell*   cell b
+			 * @return  double       cost between a and b
+			 */
+			double _cost(Map::Cell* a, Map::Cell* b);
+
+			/**
+			 * Sets the intra edges between two nodes (both ways).
+			 *
+			 * @param   Map::Cell*     node a
+			 * @param   Map::Cell*     node b
+			 * @param   double         cost (Math::INF removes the edges)
+			 * @param   vector<bool>&  cells on the path (by local index)
+			 * @return  void
+			 */
+			void _edge(Map::Cell* a, Map::Cell* b, double cost, const vector<bool>& used = vector<bool>());
+
+			/**
+			 * Calculates heuristic between two cells (octile distance).
+			 *
+			 * @param   Map::Cell*   cell a
+			 * @param   Map::Cell*   cell b
+			 * @return  double       heuristic value
+			 */
+			double _h(Map::Cell* a, Map::Cell* b);
+
+			/**
+			 * Gets the intra edge from one node to another.
+			 *
+			 * @param   Map::Cell*   node a
+			 * @param   Map::Cell*   node b
+			 * @return  Edge*        edge (NULL without one)
+			 */
+			Edge* _intra(Map::Cell* a, Map::Cell* b);
+
+			/**
+			 * Calculates key value for a node.
+			 *
+			 * @param   Map::Cell*            node
+			 * @return  pair<double,double>   key value
+			 */
+			pair<double,double> _k(Map::Cell* u);
+
+			/**
+			 * Connects a node to other nodes of its cluster by shortest paths,
+			 * and keeps the cells of each path on its edge.
+			 *
+			 * @param   Window&               cluster costs
+			 * @param   Map::Cell*            node
+			 * @param   vector<Map::Cell*>&   other nodes
+			 * @return  void
+			 */
+			void _link(const Window& window, Map::Cell* u, const vector<Map::Cell*>& targets);
+
+			/**
+			 * Gets the index of a cell inside its cluster.
+			 *
+			 * @param   Map::Cell*     cell
+			 * @return  unsigned int   index
+			 */
+			unsigned int _local(Map::Cell* u);
+
+			/**
+			 * Finds the minimum successor node.
+			 *
+			 * @param   Map::Cell*                node
+			 * @return  pair<Map::Cell*,double>   successor and rhs value
+			 */
+			pair<Map::Cell*,double> _min_succ(Map::Cell* u);
+
+			/**
+			 * Gets a node, adding it if needed.
+			 *
+			 * @param   Map::Cell*   cell
+			 * @return  Node*
+			 */
+			Node* _node(Map::Cell* u);
+
+			/**
+			 * Re-evaluates the start node after one of its successors changed.
+			 *
+			 * @param   Map::Cell*   expanded node
+			 * @return  void
+			 */
+			void _notify(Map::Cell* u);
+
+			/**
+			 * Brings dirty clusters and the start node up to date.
+			 *
+			 * @return  void
+			 */
+			void _prepare();
+
+			/**
+			 * Refines the path in the clusters around the start to cells.
+			 *
+			 * @return  bool   successful
+			 */
+			bool _refine();
+
+			/**
+			 * Removes a node.
+			 *
+			 * @param   Map::Cell*   cell
+			 * @return  void
+			 */
+			void _remove(Map::Cell* u);
+
+			/**
+			 * Searches the intra edges of a cluster again where changes can have
+			 * altered them, and links the nodes that opened.
+			 *
+			 * An edge is searched again when a cell of its path got more
+			 * expensive, or when a cheaper cell could lie on a shorter path.
+			 *
+			 * @param   unsigned int          cluster
+			 * @param   vector<Map::Cell*>&   nodes that opened (sorted)
+			 * @return  void
+			 */
+			void _repair(unsigned int c, const vector<Map::Cell*>& added);
+
+			/**
+			 * Finds the transitions on one cluster side.
+			 *
+			 * @param   unsigned int   side (2 * cluster + 0 right, + 1 bottom)
+			 * @return  void
+			 */
+			void _scan(unsigned int b);
+
+			/**
+			 * Searches shortest paths from a cell without leaving a window:
+			 * Dijkstra until every target is settled, or A* with one target.
+			 *
+			 * @param   Window&               costs
+			 * @param   Map::Cell*            source
+			 * @param   vector<Map::Cell*>&   targets
+			 * @param   vector<double>&       distances by window index
+			 * @param   vector<unsigned int>& parents by window index
+			 * @return  void
+			 */
+			void _search(const Window& window, Map::Cell* source, const vector<Map::Cell*>& targets, vector<double>& dist, vector<unsigned int>& parent);
+
+			/**
+			 * Determines if a change can alter the refined hop or an abstract
+			 * edge on the path.
+			 *
+			 * @param   Map::Cell*   changed cell
+			 * @param   bool         got cheaper
+			 * @return  bool
+			 */
+			bool _touches(Map::Cell* u, bool cheaper);
+
+			/**
+			 * Removes the transitions on one cluster side.
+			 *
+			 * @param   unsigned int   side
+			 * @return  void
+			 */
+			void _unscan(unsigned int b);
+
+			/**
+			 * Updates a node.
+			 *
+			 * @param   Map::Cell*   node to update
+			 * @return  void
+			 */
+			void _update(Map::Cell* u);
+
+			/**
+			 * Copies the cell costs of a rectangle of clusters.
+			 *
+			 * @param   unsigned int   left and top cluster column and row
+			 * @param   unsigned int   right and bottom cluster column and row
+			 * @param   Window&        window
+			 * @return  void
+			 */
+			void _window(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1, Window& window);
+	};
+};
+
+#endif // DSTARLITE_HIERARCHICAL_PLANNER_H
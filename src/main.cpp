@@ -3,6 +3,7 @@
 #include <stdlib.h>
 
 #include "simulator.h"
+#include "trace.h"
 
 /**
  * Main.
@@ -37,9 +38,17 @@ int main(int argc, char **argv)
 	// Robot scan radius
 	config.scan_radius = atoi(argv[8]);
 
+#ifdef DSTARLITE_TRACE
+	Trace::open("trace.json");
+#endif
+
 	// Build the simulator and draw
 	Simulator sim = Simulator(argv[1], config);
 	sim.draw();
 
+#ifdef DSTARLITE_TRACE
+	Trace::close();
+#endif
+
 	return 0;
 }
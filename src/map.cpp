@@ -6,154 +6,208 @@
  * @copyright	Copyright (C) 2011 Aaron Zampaglione
  * @license		MIT
  */
+#include <new>
+
 #include "map.h"
 
 using namespace std;
 using namespace DStarLite;
 
 /**
- * @var  unsigned int  number of cell neighbors
+ * @var  double  cost of an unwalkable tile
  */
-const unsigned int Map::Cell::NUM_NBRS = 8;
+const double Map::Cell::COST_UNWALKABLE = DBL_MAX;
 
 /**
- * @var  double  cost of an unwalkable tile
+ * Constructor.
  */
-const double Map::Cell::COST_UNWALKABLE = DBL_MAX;
+Map::Config::Config()
+{
+	cost = 1.0;
+	format = CostLayer::FORMAT_DOUBLE;
+	tile_size = 0;
+}
 
 /**
- * @var  int  hash "constant" (may need to change if map width exceeds this value)
+ * Constructor.
+ *
+ * @param  unsigned int                    rows
+ * @param  unsigned int                    columns
+ * @param  CostLayer::Format [optional]    cost storage
  */
-const int Map::Cell::Hash::C = 1000000;
+Map::Map(unsigned int rows, unsigned int cols, CostLayer::Format format)
+{
+	Config config;
+	config.format = format;
+
+	_init(rows, cols, config);
+}
 
 /**
  * Constructor.
  *
  * @param  unsigned int   rows
  * @param  unsigned int   columns
+ * @param  Config         config options
  */
-Map::Map(unsigned int rows, unsigned int cols)
+Map::Map(unsigned int rows, unsigned int cols, Config config)
 {
-	_rows = rows;
-	_cols = cols;
+	_init(rows, cols, config);
+}
 
-	_cells = new Cell**[rows];
+/**
+ * Constructor (contiguous, on existing costs, e.g. a mapped Costmap).
+ *
+ * @param  unsigned int   rows
+ * @param  unsigned int   columns
+ * @param  CostLayer*     rows * columns costs (the map takes ownership)
+ */
+Map::Map(unsigned int rows, unsigned int cols, CostLayer* costs)
+{
+	Config config;
+	config.format = costs->format();
 
-	for (unsigned int i = 0; i < rows; i++)
-	{
-		_cells[i] = new Cell*[cols];
+	_init(rows, cols, config, costs);
+}
 
-		for (unsigned int j = 0; j < cols; j++)
-		{
-			// Initialize cells
-			_cells[i][j] = new Cell(j, i);
-		}
-	}
+/**
+ * Deconstructor.
+ */
+Map::~Map()
+{
+	// Cells have nothing to destroy
+	::operator delete(_cells);
 
-	// Attach neighbors
-	for (unsigned int i = 0; i < rows; i++)
+	delete _costs;
+
+	for (unsigned int i = 0; i < _directory.size(); i++)
 	{
-		for (unsigned int j = 0; j < cols; j++)
-		{
-			Cell** nbrs = new Cell*[Cell::NUM_NBRS];
-			for (unsigned int k = 0; k < Cell::NUM_NBRS; k++)
-			{
-				nbrs[k] = NULL;
-			}
+		::operator delete(_directory[i]->cells);
+		delete _directory[i]->costs;
+		delete _directory[i];
+	}
 
-			// Top
-			if (i != 0)
-			{
-				if (j != 0)
-				{
-					// Top left
-					nbrs[0] = _cells[i - 1][j - 1];
-				}
+	delete[] _tiles;
+}
 
-				// Top middle
-				nbrs[1] = _cells[i - 1][j];
+/**
+ * Gets a checksum of the size and every cost (64-bit FNV-1a).
+ *
+ * @return  uint64_t
+ */
+uint64_t Map::checksum()
+{
+	const uint64_t prime = ((uint64_t) 0x100 << 32) | 0x1B3;
+	uint64_t hash = ((uint64_t) 0xCBF29CE4 << 32) | 0x84222325;
 
-				if (j < cols - 1)
-				{
-					// Top right
-					nbrs[2] = _cells[i - 1][j + 1];
-				}
-			}
+	// Untouched tiles have the default cost, as their layer would store it
+	CostLayer fill(1, _config.format, _config.cost);
+	double untouched = fill.get(0);
+
+	unsigned int size[2] = {_rows, _cols};
+	const unsigned char* bytes = (const unsigned char*) size;
+
+	for (unsigned int k = 0; k < sizeof(size); k++)
+	{
+		hash = (hash ^ bytes[k]) * prime;
+	}
+
+	for (unsigned int i = 0; i < _rows; i++)
+	{
+		for (unsigned int j = 0; j < _cols; j++)
+		{
+			double cost = untouched;
 
-			if (j < cols - 1)
+			if (_tiles == NULL)
 			{
-				// Middle right
-				nbrs[3] = _cells[i][j + 1];
+				cost = _costs->get(i * _cols + j);
 			}
-			
-			// Bottom
-			if (i < rows - 1)
+			else
 			{
-				if (j < cols - 1)
-				{
-					// Bottom right
-					nbrs[4] = _cells[i + 1][j + 1];
-				}
-
-				// Bottom middle
-				nbrs[5] = _cells[i + 1][j];
+				Tile* t = _tiles[(i >> _tile_bits) * _tiles_x + (j >> _tile_bits)];
 
-				if (j != 0)
+				if (t != NULL)
 				{
-					// Bottom left
-					nbrs[6] = _cells[i + 1][j - 1];
+					cost = t->costs->get(((i & _tile_mask) << _tile_bits) + (j & _tile_mask));
 				}
 			}
 
-			if (j != 0)
+			bytes = (const unsigned char*) &cost;
+
+			for (unsigned int k = 0; k < sizeof(double); k++)
 			{
-				// Middle left
-				nbrs[7] = _cells[i][j - 1];
+				hash = (hash ^ bytes[k]) * prime;
 			}
-
-			_cells[i][j]->init(nbrs);
 		}
 	}
+
+	return hash;
 }
 
 /**
- * Deconstructor.
+ * Gets number of cols.
+ *
+ * @return  unsigned int
  */
-Map::~Map()
+unsigned int Map::cols()
 {
-	for (unsigned int i = 0; i < _rows; i++)
-	{
-		for (unsigned int j = 0; j < _cols; j++)
-		{
-			delete _cells[i][j];
-		}
-
-		delete[] _cells[i];
-	}
-
-	delete[] _cells;
+	return _cols;
 }
 
 /**
- * Retrieves a cell.
+ * Gets the cost layer.
  *
- * @param   unsigned int   row
- * @param   unsigned int   column
- * @return  Map::Cell*
+ * @return  CostLayer*   (NULL for tiled maps, every tile has its own)
  */
-Map::Cell* Map::operator()(const unsigned int row, const unsigned int col)
+CostLayer* Map::costs()
 {
-	return _cells[row][col];
+	return _costs;
 }
 
 /**
- * Gets number of cols.
+ * Grows a tiled map (existing cells keep their place).
  *
- * @return  unsigned int
+ * @param   unsigned int   new rows (at least the current rows)
+ * @param   unsigned int   new columns (at least the current columns)
+ * @return  bool           grown (false for contiguous maps)
  */
-unsigned int Map::cols()
+bool Map::grow(unsigned int rows, unsigned int cols)
 {
-	return _cols;
+	if (_tiles == NULL || rows < _rows || cols < _cols)
+		return false;
+
+	unsigned int tiles_x = (cols + _tile_mask) >> _tile_bits;
+	unsigned int tiles_y = (rows + _tile_mask) >> _tile_bits;
+
+	// Only the directory is copied, tiles stay where they are
+	if (tiles_x != _tiles_x || tiles_y != _tiles_y)
+	{
+		Tile** tiles = new Tile*[tiles_x * tiles_y];
+
+		for (unsigned int i = 0; i < tiles_x * tiles_y; i++)
+		{
+			tiles[i] = NULL;
+		}
+
+		for (unsigned int i = 0; i < _tiles_y; i++)
+		{
+			for (unsigned int j = 0; j < _tiles_x; j++)
+			{
+				tiles[i * tiles_x + j] = _tiles[i * _tiles_x + j];
+			}
+		}
+
+		delete[] _tiles;
+
+		_tiles = tiles;
+		_tiles_x = tiles_x;
+		_tiles_y = tiles_y;
+	}
+
+	_rows = rows;
+	_cols = cols;
+
+	return true;
 }
 
 /**
@@ -179,77 +233,136 @@ unsigned int Map::rows()
 }
 
 /**
- * Constructor.
+ * Checks if the map is tiled.
  *
- * @param   unsigned int        x-coordinate
- * @param   unsigned int        y-coordinate
- * @param   double [optional]   cost of the cell
- */				
-Map::Cell::Cell(unsigned int x, unsigned int y, double cost)
+ * @return  bool
+ */
+bool Map::tiled()
 {
-	_init = false;
-
-	_nbrs = NULL;
-
-	_x = x;
-	_y = y;
-
-	this->cost = cost;
+	return _tiles != NULL;
 }
 
 /**
- * Deconstructor.
+ * Gets the number of allocated tiles.
+ *
+ * @return  unsigned int
  */
-Map::Cell::~Cell()
+unsigned int Map::tiles()
 {
-	if (_nbrs != NULL)
-		delete[] _nbrs;
+	return (unsigned int) _directory.size();
 }
 
 /**
- * Initialize.
+ * Gets the tile width and height.
  *
- * @param   Cell**  cell neighbors
- * @return  void
+ * @return  unsigned int   (0 for contiguous maps)
  */
-void Map::Cell::init(Cell** nbrs)
+unsigned int Map::tile_size()
 {
-	if (_init)
-		return;
-
-	_init = true;
-
-	_nbrs = nbrs;
+	return (_tiles != NULL) ? _tile_mask + 1 : 0;
 }
 
 /**
- * Gets cell neighbors.
+ * Allocates a tile.
  *
- * @return  Cell**
+ * @param   unsigned int   tile row
+ * @param   unsigned int   tile column
+ * @return  Tile*
  */
-Map::Cell** Map::Cell::nbrs()
+Map::Tile* Map::_allocate(unsigned int ty, unsigned int tx)
 {
-	return _nbrs;
+	unsigned int size = _tile_mask + 1;
+
+	Tile* t = new Tile();
+	t->id = (unsigned int) _directory.size();
+	t->costs = new CostLayer(size * size, _config.format, _config.cost);
+	t->cells = (Cell*) ::operator new(sizeof(Cell) * size * size);
+
+	for (unsigned int i = 0; i < size; i++)
+	{
+		for (unsigned int j = 0; j < size; j++)
+		{
+			new (t->cells + i * size + j) Cell((tx << _tile_bits) + j, (ty << _tile_bits) + i);
+		}
+	}
+
+	_directory.push_back(t);
+	_tiles[ty * _tiles_x + tx] = t;
+
+	return t;
 }
 
 /**
- * Gets x-coordinate.
+ * Builds the map.
  *
- * @return  unsigned int
+ * @param   unsigned int   rows
+ * @param   unsigned int   columns
+ * @param   Config                  config options
+ * @param   CostLayer* [optional]   costs to take over (contiguous only)
+ * @return  void
  */
-unsigned int Map::Cell::x()
+void Map::_init(unsigned int rows, unsigned int cols, Config config, CostLayer* costs)
 {
-	return _x;
+	_rows = rows;
+	_cols = cols;
+	_config = config;
+
+	_cells = NULL;
+	_costs = NULL;
+	_tiles = NULL;
+	_tile_bits = 0;
+	_tile_mask = 0;
+	_tiles_x = 0;
+	_tiles_y = 0;
+
+	if (config.tile_size > 0 && costs == NULL)
+	{
+		// Round the tile size up to a power of 2
+		while ((1u << _tile_bits) < config.tile_size)
+		{
+			_tile_bits++;
+		}
+
+		_tile_mask = (1u << _tile_bits) - 1;
+		_tiles_x = (cols + _tile_mask) >> _tile_bits;
+		_tiles_y = (rows + _tile_mask) >> _tile_bits;
+
+		// Tiles are allocated on first touch
+		_tiles = new Tile*[_tiles_x * _tiles_y];
+
+		for (unsigned int i = 0; i < _tiles_x * _tiles_y; i++)
+		{
+			_tiles[i] = NULL;
+		}
+
+		return;
+	}
+
+	_costs = (costs != NULL) ? costs : new CostLayer(rows * cols, config.format, config.cost);
+
+	// One block for every cell, constructed in place
+	_cells = (Cell*) ::operator new(sizeof(Cell) * rows * cols);
+
+	for (unsigned int i = 0; i < rows; i++)
+	{
+		for (unsigned int j = 0; j < cols; j++)
+		{
+			// Initialize cells
+			new (_cells + i * cols + j) Cell(j, i);
+		}
+	}
 }
 
 /**
- * Gets y-coordinate.
+ * Constructor.
  *
- * @return  unsigned int
- */
-unsigned int Map::Cell::y()
+ * @param   unsigned int   x-coordinate
+ * @param   unsigned int   y-coordinate
+ */				
+Map::Cell::Cell(unsigned int x, unsigned int y)
 {
-	return _y;
+	_x = x;
+	_y = y;
 }
 
 /**
@@ -260,5 +373,6 @@ unsigned int Map::Cell::y()
  */
 size_t Map::Cell::Hash::operator()(Cell* c) const
 {
-	return Cell::Hash::C * c->y() + c->x();
-}
\ No newline at end of file
+	// Odd multiplier, distinct for every coordinate pair when size_t is 64-bit
+	return (size_t) c->y() * 2654435761u + c->x();
+}
@@ -10,14 +10,29 @@
 #define DSTARLITE_MAP_H
 
 #include <functional>
+#include <stdint.h>
 #include <stdlib.h>
+#include <vector>
 
+#include "cost_layer.h"
 #include "math.h"
+#include "neighborhood.h"
 
 using namespace std;
 
 namespace DStarLite
 {
+	/**
+	 * Grid map.
+	 *
+	 * Cells are either one contiguous row-major block (the default) or square
+	 * tiles that are allocated the first time one of their cells is asked
+	 * for, so a mostly unexplored site only pays for the area it has seen.
+	 * Tiled maps can also grow past their initial bounds.
+	 *
+	 * Tiles are allocated on reads, so a tiled map shared by several threads
+	 * must already hold every tile they will touch.
+	 */
 	class Map
 	{
 		public:
@@ -34,12 +49,7 @@ namespace DStarLite
 						public:
 
 							/**
-							 * @var  int  hash "constant" (may need to change if width exceeds this value)
-							 */
-							static const int C;
-
-							/**
-							 * Hashes cell based on coordinates.
+							 * Hashes cell based on coordinates (any width).
 							 *
 							 * @param   Cell*
 							 * @return  size_t
@@ -47,94 +57,111 @@ namespace DStarLite
 							size_t operator()(Cell* c) const;
 					};
 
-					/**
-					 * @var  static const int  number of cell neighbors
-					 */
-					static const unsigned int NUM_NBRS;
-
 					/**
 					 * @var  static const double  cost of an unwalkable cell
 					 */
 					static const double COST_UNWALKABLE;
 
-					/**
-					 * @var  double  cost of cell
-					 */
-					double cost;
-
 					/**
 					 * Constructor.
 					 *
-					 * @param   unsigned int        x-coordinate
-					 * @param   unsigned int        y-coordinate
-					 * @param   double [optional]   cost of the cell
-					 */
-					Cell(unsigned int x, unsigned int y, double cost = 1.0);
-
-					/**
-					 * Deconstructor.
-					 */
-					~Cell();
-
-					/**
-					 * Initialize.
-					 *
-					 * @param   Cell**  cell neighbors
-					 * @return  void
-					 */
-					void init(Cell** nbrs);
-
-					/**
-					 * Gets cell neighbors.
+					 * Costs are kept by the map, see Map::cost().
 					 *
-					 * @return  Cell**
+					 * @param   unsigned int   x-coordinate
+					 * @param   unsigned int   y-coordinate
 					 */
-					Cell** nbrs();
+					Cell(unsigned int x, unsigned int y);
 
 					/**
 					 * Gets x-coordinate.
 					 *
 					 * @return  unsigned int
 					 */
-					unsigned int x();
+					unsigned int x()
+					{
+						return _x;
+					}
 
 					/**
 					 * Gets y-coordinate.
 					 *
 					 * @return  unsigned int
 					 */
-					unsigned int y();
+					unsigned int y()
+					{
+						return _y;
+					}
 
 				protected:
 
 					/**
-					 * @var  bool  initialized
+					 * @var  unsigned int  x-coordinate
 					 */
-					bool _init;
+					unsigned int _x;
 
 					/**
-					 * @var  Cell**  neighbors
+					 * @var  unsigned int  y-coordinate
 					 */
-					Cell** _nbrs;
+					unsigned int _y;
+			};
+
+			/**
+			 * Config class.
+			 */
+			class Config
+			{
+				public:
 
 					/**
-					 * @var  unsigned int  x-coordinate
+					 * @var  double  cost of every cell until it is set
 					 */
-					unsigned int _x;
+					double cost;
 
 					/**
-					 * @var  unsigned int  y-coordinate
+					 * @var  CostLayer::Format  cost storage
 					 */
-					unsigned int _y;
+					CostLayer::Format format;
+
+					/**
+					 * @var  unsigned int  tile width and height, a power of 2 (0 for one contiguous block)
+					 */
+					unsigned int tile_size;
+
+					/**
+					 * Constructor.
+					 */
+					Config();
 			};
 
 			/**
 			 * Constructor.
 			 *
+			 * All cells live in one row-major array, their costs (all 1) in a
+			 * CostLayer of the same order.
+			 *
+			 * @param  unsigned int                    rows
+			 * @param  unsigned int                    columns
+			 * @param  CostLayer::Format [optional]    cost storage
+			 */
+			Map(unsigned int rows, unsigned int cols, CostLayer::Format format = CostLayer::FORMAT_DOUBLE);
+
+			/**
+			 * Constructor.
+			 *
+			 * @param  unsigned int   rows
+			 * @param  unsigned int   columns
+			 * @param  Config         config options
+			 */
+			Map(unsigned int rows, unsigned int cols, Config config);
+
+			/**
+			 * Constructor (contiguous, on existing costs, e.g. a mapped Costmap).
+			 *
 			 * @param  unsigned int   rows
 			 * @param  unsigned int   columns
+			 * @param  CostLayer*     rows * columns costs (the map takes ownership)
 			 */
-			Map(unsigned int rows, unsigned int cols);
+			Map(unsigned int rows, unsigned int cols, CostLayer* costs);
 
 			/**
 			 * Deconstructor.
@@ -148,7 +175,23 @@ namespace DStarLite
 			 * @param   unsigned int   column
 			 * @return  Map::Cell*
 			 */
-			Cell* operator()(const unsigned int row, const unsigned int col);
+			Cell* operator()(const unsigned int row, const unsigned int col)
+			{
+				if (_tiles == NULL)
+					return _cells + row * _cols + col;
+
+				return _tile(row >> _tile_bits, col >> _tile_bits)->cells + ((row & _tile_mask) << _tile_bits) + (col & _tile_mask);
+			}
+
+			/**
+			 * Gets a checksum of the size and every cost (64-bit FNV-1a).
+			 *
+			 * Costs are hashed as doubles, so the same costs in another format
+			 * check the same. Tiles that were never touched are not allocated.
+			 *
+			 * @return  uint64_t
+			 */
+			uint64_t checksum();
 
 			/**
 			 * Gets number of cols.
@@ -157,6 +200,94 @@ namespace DStarLite
 			 */
 			unsigned int cols();
 
+			/**
+			 * Gets the cost of a cell.
+			 *
+			 * @param   Cell*    cell
+			 * @return  double   cost
+			 */
+			double cost(Cell* u)
+			{
+				if (_tiles == NULL)
+					return _costs->get(index(u));
+
+				unsigned int offset;
+				return _locate(u, &offset)->costs->get(offset);
+			}
+
+			/**
+			 * Sets the cost of a cell.
+			 *
+			 * @param   Cell*    cell
+			 * @param   double   cost (rounded by compact layers)
+			 * @return  void
+			 */
+			void cost(Cell* u, double cost)
+			{
+				if (_tiles == NULL)
+				{
+					_costs->set(index(u), cost);
+					return;
+				}
+
+				unsigned int offset;
+				_locate(u, &offset)->costs->set(offset, cost);
+			}
+
+			/**
+			 * Gets the cost layer.
+			 *
+			 * @return  CostLayer*   (NULL for tiled maps, every tile has its own)
+			 */
+			CostLayer* costs();
+
+			/**
+			 * Grows a tiled map (existing cells keep their place).
+			 *
+			 * @param   unsigned int   new rows (at least the current rows)
+			 * @param   unsigned int   new columns (at least the current columns)
+			 * @return  bool           grown (false for contiguous maps)
+			 */
+			bool grow(unsigned int rows, unsigned int cols);
+
+			/**
+			 * Gathers the neighbors of a cell that lie inside the map.
+			 *
+			 * @param   Cell*          cell
+			 * @param   Cell**         neighbors (room for N::SIZE cells)
+			 * @return  unsigned int   number of neighbors
+			 */
+			template <typename N>
+			unsigned int nbrs(Cell* u, Cell** nbrs)
+			{
+				unsigned int x = u->x();
+				unsigned int y = u->y();
+
+				if (_tiles == NULL)
+				{
+					// Away from the border every neighbor exists
+					if (x >= N::RADIUS && y >= N::RADIUS && x + N::RADIUS < _cols && y + N::RADIUS < _rows)
+					{
+						NeighborLoop<N>::gather(u, _cols, nbrs);
+						return N::SIZE;
+					}
+
+					return NeighborLoop<N>::clip(u, x, y, _rows, _cols, nbrs, 0);
+				}
+
+				// Away from the tile border every neighbor is in the same tile
+				unsigned int tx = x & _tile_mask;
+				unsigned int ty = y & _tile_mask;
+
+				if (tx >= N::RADIUS && ty >= N::RADIUS && tx + N::RADIUS <= _tile_mask && ty + N::RADIUS <= _tile_mask && x + N::RADIUS < _cols && y + N::RADIUS < _rows)
+				{
+					NeighborLoop<N>::gather(u, _tile_mask + 1, nbrs);
+					return N::SIZE;
+				}
+
+				return NeighborLoop<N>::fetch(this, x, y, _rows, _cols, nbrs, 0);
+			}
+
 			/**
 			 * Checks if row/col exists.
 			 *
@@ -166,6 +297,33 @@ namespace DStarLite
 			 */
 			bool has(unsigned int row, unsigned int col);
 
+			/**
+			 * Gets the index of a cell (contiguous maps only).
+			 *
+			 * @param   Cell*          cell
+			 * @return  unsigned int   row * cols + col
+			 */
+			unsigned int index(Cell* u)
+			{
+				return (unsigned int) (u - _cells);
+			}
+
+			/**
+			 * Finds the tile of a cell (tiled maps only).
+			 *
+			 * Tile ids are handed out in allocation order and never change, not
+			 * even when the map grows.
+			 *
+			 * @param   Cell*           cell
+			 * @param   unsigned int*   tile id
+			 * @param   unsigned int*   index inside the tile
+			 * @return  void
+			 */
+			void locate(Cell* u, unsigned int* tile, unsigned int* offset)
+			{
+				*tile = _locate(u, offset)->id;
+			}
+
 			/**
 			 * Gets number of rows.
 			 *
@@ -173,22 +331,161 @@ namespace DStarLite
 			 */
 			unsigned int rows();
 
+			/**
+			 * Checks if the map is tiled.
+			 *
+			 * @return  bool
+			 */
+			bool tiled();
+
+			/**
+			 * Gets the number of allocated tiles.
+			 *
+			 * @return  unsigned int
+			 */
+			unsigned int tiles();
+
+			/**
+			 * Gets the tile width and height.
+			 *
+			 * @return  unsigned int   (0 for contiguous maps)
+			 */
+			unsigned int tile_size();
+
 	protected:
-			
+
+			/**
+			 * Tile.
+			 */
+			struct Tile
+			{
+				/**
+				 * @var  Cell*  cells (row-major inside the tile)
+				 */
+				Cell* cells;
+
+				/**
+				 * @var  CostLayer*  costs
+				 */
+				CostLayer* costs;
+
+				/**
+				 * @var  unsigned int  id (allocation order)
+				 */
+				unsigned int id;
+			};
+
 			/**
-			 * @var  Cell***  cells of the map
+			 * @var  Cell*  cells of the map (row-major, NULL for tiled maps)
 			 */
-			Cell*** _cells;
+			Cell* _cells;
 
 			/**
 			 * @var  unsigned int columns
 			 */
 			unsigned int _cols;
 
+			/**
+			 * @var  Config  map config options
+			 */
+			Config _config;
+
+			/**
+			 * @var  CostLayer*  cell costs (NULL for tiled maps)
+			 */
+			CostLayer* _costs;
+
+			/**
+			 * @var  vector<Tile*>  allocated tiles by id
+			 */
+			vector<Tile*> _directory;
+
 			/**
 			 * @var  unsigned int  rows
 			 */
 			unsigned int _rows;
+
+			/**
+			 * @var  unsigned int  log2 of the tile size
+			 */
+			unsigned int _tile_bits;
+
+			/**
+			 * @var  unsigned int  tile size - 1
+			 */
+			unsigned int _tile_mask;
+
+			/**
+			 * @var  Tile**  tiles by tile row and column (NULL until touched, NULL for contiguous maps)
+			 */
+			Tile** _tiles;
+
+			/**
+			 * @var  unsigned int  tile columns and rows
+			 */
+			unsigned int _tiles_x;
+			unsigned int _tiles_y;
+
+			/**
+			 * Allocates a tile.
+			 *
+			 * @param   unsigned int   tile row
+			 * @param   unsigned int   tile column
+			 * @return  Tile*
+			 */
+			Tile* _allocate(unsigned int ty, unsigned int tx);
+
+			/**
+			 * Builds the map.
+			 *
+			 * @param   unsigned int   rows
+			 * @param   unsigned int   columns
+			 * @param   Config                  config options
+			 * @param   CostLayer* [optional]   costs to take over (contiguous only)
+			 * @return  void
+			 */
+			void _init(unsigned int rows, unsigned int cols, Config config, CostLayer* costs = NULL);
+
+			/**
+			 * Finds the tile of a cell.
+			 *
+			 * @param   Cell*           cell
+			 * @param   unsigned int*   index inside the tile
+			 * @return  Tile*
+			 */
+			Tile* _locate(Cell* u, unsigned int* offset)
+			{
+				unsigned int x = u->x();
+				unsigned int y = u->y();
+
+				*offset = ((y & _tile_mask) << _tile_bits) + (x & _tile_mask);
+				return _tiles[(y >> _tile_bits) * _tiles_x + (x >> _tile_bits)];
+			}
+
+			/**
+			 * Gets a tile, allocating it on first touch.
+			 *
+			 * @param   unsigned int   tile row
+			 * @param   unsigned int   tile column
+			 * @return  Tile*
+			 */
+			Tile* _tile(unsigned int ty, unsigned int tx)
+			{
+				Tile* t = _tiles[ty * _tiles_x + tx];
+				return (t != NULL) ? t : _allocate(ty, tx);
+			}
+
+		private:
+
+			/**
+			 * Not copyable.
+			 */
+			Map(const Map&);
+
+			/**
+			 * Not assignable.
+			 */
+			Map& operator=(const Map&);
 	};
 };
 
@@ -25,6 +25,11 @@ const double Math::PI = 3.14159265;
  */
 const double Math::SQRT2 = 1.41421356237309504880;
 
+/**
+ * @var  double  SQRT5
+ */
+const double Math::SQRT5 = 2.23606797749978969641;
+
 /**
  * Converts degrees to radians.
  *
@@ -33,6 +33,11 @@ namespace DStarLite
 			 */
 			static const double SQRT2;
 
+			/**
+			 * @var  double  SQRT5
+			 */
+			static const double SQRT5;
+
 			/**
 			 * Converts degrees to radians.
 			 *
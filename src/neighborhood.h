@@ -0,0 +1,253 @@
+/**
+ * Neighborhood.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#ifndef DSTARLITE_NEIGHBORHOOD_H
+#define DSTARLITE_NEIGHBORHOOD_H
+
+#include <cmath>
+
+#include "cost.h"
+
+using namespace std;
+
+namespace DStarLite
+{
+	/**
+	 * Grid connectivity policies.
+	 *
+	 * A policy is a set of compile-time constants and an offset table:
+	 *
+	 *   SIZE       number of neighbors
+	 *   RADIUS     largest coordinate offset
+	 *   CROSSING   some moves pass between cells that are not their endpoints
+	 *   dx(i)      column offset of neighbor i
+	 *   dy(i)      row offset of neighbor i
+	 *   h<T>()     heuristic for a coordinate difference (a lower bound on any path)
+	 *
+	 * Indices run clockwise from the top left, straight and diagonal moves
+	 * first, so the 8-connected order is the one the map always used.
+	 */
+
+	/**
+	 * 4-connected neighborhood (no diagonal moves).
+	 */
+	class Neighborhood4
+	{
+		public:
+
+			static const unsigned int SIZE = 4;
+			static const unsigned int RADIUS = 1;
+			static const bool CROSSING = false;
+
+			static int dx(unsigned int i)
+			{
+				static const int DX[SIZE] = { 0, 1, 0, -1 };
+				return DX[i];
+			}
+
+			static int dy(unsigned int i)
+			{
+				static const int DY[SIZE] = { -1, 0, 1, 0 };
+				return DY[i];
+			}
+
+			/**
+			 * Manhattan distance.
+			 *
+			 * @param   unsigned int   column difference
+			 * @param   unsigned int   row difference
+			 * @return  T
+			 */
+			template <typename T>
+			static T h(unsigned int dx, unsigned int dy)
+			{
+				return Cost<T>::bound(dx + dy);
+			}
+	};
+
+	/**
+	 * 8-connected neighborhood.
+	 */
+	class Neighborhood8
+	{
+		public:
+
+			static const unsigned int SIZE = 8;
+			static const unsigned int RADIUS = 1;
+			static const bool CROSSING = false;
+
+			static int dx(unsigned int i)
+			{
+				static const int DX[SIZE] = { -1, 0, 1, 1, 1, 0, -1, -1 };
+				return DX[i];
+			}
+
+			static int dy(unsigned int i)
+			{
+				static const int DY[SIZE] = { -1, -1, -1, 0, 1, 1, 1, 0 };
+				return DY[i];
+			}
+
+			/**
+			 * Octile distance.
+			 *
+			 * @param   unsigned int   column difference
+			 * @param   unsigned int   row difference
+			 * @return  T
+			 */
+			template <typename T>
+			static T h(unsigned int dx, unsigned int dy)
+			{
+				return (dx < dy) ? Cost<T>::octile(dx, dy) : Cost<T>::octile(dy, dx);
+			}
+	};
+
+	/**
+	 * 16-connected neighborhood (8-connected plus knight moves).
+	 *
+	 * A knight move passes between the two cells beside its midpoint, so it
+	 * is CROSSING: a change to those cells changes the move's cost too.
+	 */
+	class Neighborhood16
+	{
+		public:
+
+			static const unsigned int SIZE = 16;
+			static const unsigned int RADIUS = 2;
+			static const bool CROSSING = true;
+
+			static int dx(unsigned int i)
+			{
+				static const int DX[SIZE] = { -1, 0, 1, 1, 1, 0, -1, -1, 1, 2, 2, 1, -1, -2, -2, -1 };
+				return DX[i];
+			}
+
+			static int dy(unsigned int i)
+			{
+				static const int DY[SIZE] = { -1, -1, -1, 0, 1, 1, 1, 0, -2, -1, 1, 2, 2, 1, -1, -2 };
+				return DY[i];
+			}
+
+			/**
+			 * Euclidean distance (octile overestimates knight moves).
+			 *
+			 * @param   unsigned int   column difference
+			 * @param   unsigned int   row difference
+			 * @return  T
+			 */
+			template <typename T>
+			static T h(unsigned int dx, unsigned int dy)
+			{
+				return Cost<T>::bound(sqrt((double) dx * dx + (double) dy * dy));
+			}
+	};
+
+	/**
+	 * Unrolled walk over a neighborhood's offset table.
+	 *
+	 * One instantiation per offset, so every offset is a constant and there
+	 * is no loop left after inlining. Cells are one row-major array, so a
+	 * neighbor is the cell plus dy * cols + dx.
+	 */
+	template <typename N, unsigned int I = 0, bool END = (I == N::SIZE)>
+	struct NeighborLoop
+	{
+		/**
+		 * Gathers every neighbor (the cell must be at least RADIUS from the border).
+		 *
+		 * @param   C*             cell
+		 * @param   unsigned int   columns
+		 * @param   C**            neighbors
+		 * @return  void
+		 */
+		template <typename C>
+		static void gather(C* u, unsigned int cols, C** nbrs)
+		{
+			nbrs[I] = u + N::dy(I) * (int) cols + N::dx(I);
+			NeighborLoop<N, I + 1>::gather(u, cols, nbrs);
+		}
+
+		/**
+		 * Gathers the neighbors inside the grid.
+		 *
+		 * @param   C*             cell
+		 * @param   unsigned int   column
+		 * @param   unsigned int   row
+		 * @param   unsigned int   rows
+		 * @param   unsigned int   columns
+		 * @param   C**            neighbors
+		 * @param   unsigned int   neighbors gathered so far
+		 * @return  unsigned int   neighbors gathered
+		 */
+		template <typename C>
+		static unsigned int clip(C* u, unsigned int x, unsigned int y, unsigned int rows, unsigned int cols, C** nbrs, unsigned int n)
+		{
+			// Negative offsets wrap around and fail the bounds check
+			unsigned int nx = x + N::dx(I);
+			unsigned int ny = y + N::dy(I);
+
+			if (nx < cols && ny < rows)
+			{
+				nbrs[n++] = u + N::dy(I) * (int) cols + N::dx(I);
+			}
+
+			return NeighborLoop<N, I + 1>::clip(u, x, y, rows, cols, nbrs, n);
+		}
+
+		/**
+		 * Looks up the neighbors inside the grid through the map (cells that
+		 * are not one block, see Map).
+		 *
+		 * @param   M*             map
+		 * @param   unsigned int   column
+		 * @param   unsigned int   row
+		 * @param   unsigned int   rows
+		 * @param   unsigned int   columns
+		 * @param   C**            neighbors
+		 * @param   unsigned int   neighbors gathered so far
+		 * @return  unsigned int   neighbors gathered
+		 */
+		template <typename M, typename C>
+		static unsigned int fetch(M* map, unsigned int x, unsigned int y, unsigned int rows, unsigned int cols, C** nbrs, unsigned int n)
+		{
+			unsigned int nx = x + N::dx(I);
+			unsigned int ny = y + N::dy(I);
+
+			if (nx < cols && ny < rows)
+			{
+				nbrs[n++] = (*map)(ny, nx);
+			}
+
+			return NeighborLoop<N, I + 1>::fetch(map, x, y, rows, cols, nbrs, n);
+		}
+	};
+
+	/**
+	 * End of the walk.
+	 */
+	template <typename N, unsigned int I>
+	struct NeighborLoop<N, I, true>
+	{
+		template <typename C>
+		static void gather(C*, unsigned int, C**) {}
+
+		template <typename C>
+		static unsigned int clip(C*, unsigned int, unsigned int, unsigned int, unsigned int, C**, unsigned int n)
+		{
+			return n;
+		}
+
+		template <typename M, typename C>
+		static unsigned int fetch(M*, unsigned int, unsigned int, unsigned int, unsigned int, C**, unsigned int n)
+		{
+			return n;
+		}
+	};
+};
+
+#endif // DSTARLITE_NEIGHBORHOOD_H
@@ -0,0 +1,111 @@
+/**
+ * Open List.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#ifndef DSTARLITE_OPEN_LIST_H
+#define DSTARLITE_OPEN_LIST_H
+
+#include "map.h"
+
+using namespace std;
+
+namespace DStarLite
+{
+	/**
+	 * Priority queue interface used by the planner.
+	 *
+	 * Cells do not get looked up inside the list. Instead, the owner of a cell
+	 * hands the list a pointer to an unsigned int it keeps next to the cell's
+	 * state, and the list keeps that position current as entries move around.
+	 * A position of NONE means the cell is not in the list.
+	 */
+	template <typename K, typename C>
+	class OpenList
+	{
+		public:
+
+			/**
+			 * @var  static const unsigned int  position of a cell that is not in the list
+			 */
+			static const unsigned int NONE = (unsigned int) -1;
+
+			/**
+			 * Deconstructor.
+			 */
+			virtual ~OpenList() {}
+
+			/**
+			 * Removes all cells from the list.
+			 *
+			 * @return  void
+			 */
+			virtual void clear() = 0;
+
+			/**
+			 * Checks if the list is empty.
+			 *
+			 * @return  bool
+			 */
+			virtual bool empty() = 0;
+
+			/**
+			 * Inserts a cell.
+			 *
+			 * @param   Map::Cell*       cell to insert
+			 * @param   K                key value for the cell
+			 * @param   unsigned int*    position of the cell (kept current by the list)
+			 * @return  void
+			 */
+			virtual void insert(Map::Cell* u, K k, unsigned int* pos) = 0;
+
+			/**
+			 * Removes a cell.
+			 *
+			 * @param   unsigned int*   position of the cell
+			 * @return  void
+			 */
+			virtual void remove(unsigned int* pos) = 0;
+
+			/**
+			 * Gets the number of cells in the list.
+			 *
+			 * @return  unsigned int
+			 */
+			virtual unsigned int size() = 0;
+
+			/**
+			 * Gets the cell with the smallest key.
+			 *
+			 * @return  Map::Cell*
+			 */
+			virtual Map::Cell* top() = 0;
+
+			/**
+			 * Gets the smallest key.
+			 *
+			 * @return  K
+			 */
+			virtual K top_key() = 0;
+
+			/**
+			 * Changes the key of a cell (either direction).
+			 *
+			 * @param   unsigned int*   position of the cell
+			 * @param   K               new key value
+			 * @return  void
+			 */
+			virtual void update(unsigned int* pos, K k) = 0;
+	};
+
+	/**
+	 * @var  static const unsigned int  position of a cell that is not in the list
+	 */
+	template <typename K, typename C>
+	const unsigned int OpenList<K,C>::NONE;
+};
+
+#endif // DSTARLITE_OPEN_LIST_H
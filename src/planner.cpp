@@ -11,12 +11,95 @@
  * @copyright	Copyright (C) 2011 Aaron Zampaglione
  * @license		MIT
  */
+#define _CRT_SECURE_NO_WARNINGS
+#include <cstdio>
+#include <cstring>
+
 #include "planner.h"
+#include "timer.h"
+#include "trace.h"
 
 /*
  * @var  static const double  max steps before assuming no solution possible
  */
-const double Planner::MAX_STEPS = 1000000;
+template <typename T, typename N>
+const double BasicPlanner<T,N>::MAX_STEPS = 1000000;
+
+/**
+ * Constructor.
+ */
+template <typename T, typename N>
+BasicPlanner<T,N>::Config::Config()
+{
+	bucket_width = 0.5;
+	budget_expansions = 0;
+	budget_time = 0;
+	epsilon = 1;
+	epsilon_step = 0.5;
+	queue = QUEUE_HEAP;
+	storage = STORAGE_DENSE;
+}
+
+/**
+ * Constructor.
+ */
+template <typename T, typename N>
+BasicPlanner<T,N>::Stats::Stats()
+{
+	cells = 0;
+	compute_time = 0;
+	expansions_over = 0;
+	expansions_under = 0;
+	inserts = 0;
+	min_succ = 0;
+	open_peak = 0;
+	path_length = 0;
+	path_time = 0;
+	removes = 0;
+	updates = 0;
+}
+
+/**
+ * Adds a later record (the peak is the larger one, the path length the
+ * later one).
+ *
+ * @param   Stats   record
+ * @return  void
+ */
+template <typename T, typename N>
+void BasicPlanner<T,N>::Stats::add(const Stats& stats)
+{
+	cells += stats.cells;
+	compute_time += stats.compute_time;
+	expansions_over += stats.expansions_over;
+	expansions_under += stats.expansions_under;
+	inserts += stats.inserts;
+	min_succ += stats.min_succ;
+	path_time += stats.path_time;
+	removes += stats.removes;
+	updates += stats.updates;
+
+	if (stats.open_peak > open_peak)
+	{
+		open_peak = stats.open_peak;
+	}
+
+	if (stats.path_length > 0)
+	{
+		path_length = stats.path_length;
+	}
+}
+
+/**
+ * Gets all expansions.
+ *
+ * @return  unsigned long
+ */
+template <typename T, typename N>
+unsigned long BasicPlanner<T,N>::Stats::expansions() const
+{
+	return expansions_over + expansions_under;
+}
 
 /**
  * Constructor.
@@ -24,536 +107,2060 @@ const double Planner::MAX_STEPS = 1000000;
  * @param  Map*         map
  * @param  Map::Cell*   start cell
  * @param  Map::Cell*   goal cell
+ * @param  Config       config options
  */
-Planner::Planner(Map* map, Map::Cell* start, Map::Cell* goal)
+template <typename T, typename N>
+BasicPlanner<T,N>::BasicPlanner(Map* map, Map::Cell* start, Map::Cell* goal, Config config)
 {
+	_config = config;
+
 	// Clear lists
-	_open_list.clear();
-	_open_hash.clear();
+	if (_config.queue == Config::QUEUE_BUCKETS)
+	{
+		_open_list = new Buckets<Key, KeyCompare>(_config.bucket_width);
+	}
+	else
+	{
+		_open_list = new Heap<Key, KeyCompare>();
+	}
+
 	_path.clear();
+	_path_affected = true;
+	_path_stale = false;
 	
 	_km = 0;
+	_expansions = 0;
+	_suspended = false;
+
+	_bound = Math::INF;
+	_epsilon = max(1.0, _config.epsilon);
+
+	_dense_cost = NULL;
+	_dense_g = NULL;
+	_dense_path = NULL;
+	_dense_rhs = NULL;
+	_dense_pos = NULL;
+	_dense_set = NULL;
+	_dense_succ = NULL;
+
+	// Tiled maps only pay for the tiles the search touches
+	if (map->tiled() && _config.storage == Config::STORAGE_DENSE)
+	{
+		_config.storage = Config::STORAGE_TILED;
+	}
+
+	// Allocate all cell state up front
+	if (_config.storage == Config::STORAGE_DENSE)
+	{
+		unsigned int n = map->rows() * map->cols();
+
+		_dense_g = new T[n];
+		_dense_path = new bool[n];
+		_dense_rhs = new T[n];
+		_dense_pos = new unsigned int[n];
+		_dense_succ = new Map::Cell*[n];
+
+		for (unsigned int i = 0; i < n; i++)
+		{
+			_dense_g[i] = Cost<T>::inf();
+			_dense_path[i] = false;
+			_dense_rhs[i] = Cost<T>::inf();
+			_dense_pos[i] = OL::NONE;
+			_dense_succ[i] = NULL;
+		}
+
+		// Only the anytime search keeps sets
+		if (_epsilon > 1)
+		{
+			_dense_set = new unsigned char[n];
+			fill(_dense_set, _dense_set + n, (unsigned char) SET_NONE);
+		}
+	}
 
 	_map = map;
+	_rows = map->rows();
+	_cols = map->cols();
 	_start = start;
 	_goal = goal;
 	_last = _start;
 
-	_rhs(_goal, 0.0);
+	_rhs(_goal, (T) 0);
 
-	_list_insert(_goal, pair<double,double>(_h(_start, _goal), 0));
+	_list_insert(_goal, Cost<T>::key(_h(_start, _goal), 0));
 }
 
 /**
  * Deconstructor.
  */
-Planner::~Planner()
+template <typename T, typename N>
+BasicPlanner<T,N>::~BasicPlanner()
+{
+	delete _open_list;
+
+	delete _dense_cost;
+	delete[] _dense_g;
+	delete[] _dense_path;
+	delete[] _dense_rhs;
+	delete[] _dense_pos;
+	delete[] _dense_set;
+	delete[] _dense_succ;
+
+	for (unsigned int i = 0; i < _tiles.size(); i++)
+	{
+		delete[] _tiles[i];
+	}
+}
+
+/**
+ * Determines if a replan could change the path.
+ *
+ * @return  bool
+ */
+template <typename T, typename N>
+bool BasicPlanner<T,N>::affected()
+{
+	if (_path_stale || _path_affected || _path.empty())
+		return true;
+
+	// A tighter bound is due (see replan())
+	if (_epsilon > 1 && _bound == _epsilon && _config.epsilon_step > 0)
+		return true;
+
+	if (_map->rows() != _rows || _map->cols() != _cols)
+		return true;
+
+	// Moved off the path
+	if ( ! *_path_flag(_start))
+		return true;
+
+	// The search would run (see _compute())
+	if ( ! Cost<T>::equals(_rhs(_start), _g(_start)))
+		return true;
+
+	KeyCompare key_compare;
+
+	return ! _open_list->empty() && key_compare(_open_list->top_key(), _k(_start));
+}
+
+/**
+ * Gets the suboptimality bound of the last finished search.
+ *
+ * @return  double   bound (infinite before the first search)
+ */
+template <typename T, typename N>
+double BasicPlanner<T,N>::bound()
+{
+	return _bound;
+}
+
+/**
+ * Gets the cost of a cell as this planner knows it.
+ *
+ * @param   Map::Cell*   cell
+ * @return  double       cost
+ */
+template <typename T, typename N>
+double BasicPlanner<T,N>::cost(Map::Cell* u)
+{
+	return _cell_cost(u);
+}
+
+/**
+ * Gets the number of cells expanded by all replans (refreshing a stale key
+ * doesn't count).
+ *
+ * @return  unsigned long
+ */
+template <typename T, typename N>
+unsigned long BasicPlanner<T,N>::expansions()
 {
+	return _expansions;
 }
 
 /**
- * Returns the generated path.
+ * Returns the generated path (built on first use after a replan).
  *
  * @return  list<Map::Cell*>
  */
-list<Map::Cell*> Planner::path()
+template <typename T, typename N>
+const list<Map::Cell*>& BasicPlanner<T,N>::path()
 {
+	if ( ! _path_stale)
+		return _path;
+
+	_path_stale = false;
+
+	DSTARLITE_TRACE_SCOPE("path");
+	DSTARLITE_STAT(double started = Timer::now();)
+
+	// Follow the cached successors until goal is reached, a cell met twice
+	// means the chain loops
+	for (PathIterator i = path_begin(); i != path_end(); ++i)
+	{
+		if (*_path_flag(*i))
+			break;
+
+		_path.push_back(*i);
+		*_path_flag(*i) = true;
+	}
+
+	// Successor chain broke off, there is no usable path
+	if (_path.empty() || _path.back() != _goal)
+	{
+		_path_clear();
+	}
+
+	_path_affected = false;
+
+	DSTARLITE_STAT(_stats.path_time += Timer::now() - started;)
+	DSTARLITE_STAT(_stats.path_length = _path.size();)
+
 	return _path;
 }
 
+/**
+ * Gets an iterator at the start of the path.
+ *
+ * @return  PathIterator
+ */
+template <typename T, typename N>
+typename BasicPlanner<T,N>::PathIterator BasicPlanner<T,N>::path_begin()
+{
+	return PathIterator(this, _start);
+}
+
+/**
+ * Gets the iterator past the end of the path.
+ *
+ * @return  PathIterator
+ */
+template <typename T, typename N>
+typename BasicPlanner<T,N>::PathIterator BasicPlanner<T,N>::path_end()
+{
+	return PathIterator(this);
+}
+
 /**
  * Gets/Sets a new goal.
  *
  * @param   Map::Cell* [optional]   goal
  * @return  Map::Cell*              new goal
  */
-Map::Cell* Planner::goal(Map::Cell* u)
+template <typename T, typename N>
+Map::Cell* BasicPlanner<T,N>::goal(Map::Cell* u)
 {
 	if (u == NULL)
 		return _goal;
 
-	// Hack implementation
-	_goal = u;
+	if (u != _goal)
+	{
+		_retarget(u);
+	}
 
 	return _goal;
 }
 
+/**
+ * Restores a search from a snapshot (see save()).
+ *
+ * The file is read and checked in full before the current search is
+ * dropped. Open cells are queued again with keys from the restored km
+ * and last start, never below the ones the saved queue held, so the next
+ * replan() expands no more than the saved planner's would.
+ *
+ * @param   char*   file name
+ * @return  bool    successful (false if the file is missing, short,
+ *                  another version, byte order, cost type or
+ *                  neighborhood, or was saved on another map; the
+ *                  planner is unchanged then)
+ */
+template <typename T, typename N>
+bool BasicPlanner<T,N>::load(const char* file)
+{
+	FILE* fp = fopen(file, "rb");
+
+	if (fp == NULL)
+		return false;
+
+	Snapshot header;
+	T inf = Cost<T>::inf();
+	unsigned int size = _map->rows() * _map->cols();
+
+	bool result = fread(&header, sizeof(Snapshot), 1, fp) == 1
+		&& memcmp(header.magic, "DSLP", 4) == 0
+		&& header.version == SNAPSHOT_VERSION
+		&& header.order == SNAPSHOT_ORDER
+		&& header.cost == sizeof(T)
+		&& memcmp(header.inf, &inf, sizeof(T)) == 0
+		&& header.neighborhood == N::SIZE
+		&& header.rows == _map->rows()
+		&& header.cols == _map->cols()
+		&& header.cells <= size
+		&& header.costs <= size;
+
+	unsigned int n = result ? header.cells : 0;
+	unsigned int m = result ? header.costs : 0;
+	vector<uint32_t> index(n), succ(n), cost_index(m);
+	vector<T> g(n), rhs(n);
+	vector<unsigned char> flags(n);
+	vector<double> cost_value(m);
+
+	if (result && n > 0)
+	{
+		result = fread(&index[0], sizeof(uint32_t), n, fp) == n
+			&& fread(&succ[0], sizeof(uint32_t), n, fp) == n
+			&& fread(&g[0], sizeof(T), n, fp) == n
+			&& fread(&rhs[0], sizeof(T), n, fp) == n
+			&& fread(&flags[0], 1, n, fp) == n;
+	}
+
+	if (result && m > 0)
+	{
+		result = fread(&cost_index[0], sizeof(uint32_t), m, fp) == m
+			&& fread(&cost_value[0], sizeof(double), m, fp) == m;
+	}
+
+	fclose(fp);
+
+	if ( ! result)
+		return false;
+
+	if (header.start >= size || header.goal >= size || header.last >= size || header.epsilon < 1)
+		return false;
+
+	// Only a tiled map can have grown past the searched part since
+	if (header.searched_rows > header.rows || header.searched_cols > header.cols)
+		return false;
+
+	if (_config.storage != Config::STORAGE_TILED && (header.searched_rows != header.rows || header.searched_cols != header.cols))
+		return false;
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		unsigned char set = flags[i] & ~SNAPSHOT_OPEN;
+
+		if (index[i] >= size || (succ[i] >= size && succ[i] != SNAPSHOT_NONE))
+			return false;
+
+		// Only the anytime search keeps sets
+		if (set > SET_INCONS || (set != SET_NONE && header.epsilon == 1))
+			return false;
+	}
+
+	for (unsigned int i = 0; i < m; i++)
+	{
+		if (cost_index[i] >= size)
+			return false;
+	}
+
+	// Costs last, the full map walk is the most expensive check
+	if (header.checksum != _map->checksum())
+		return false;
+
+	// Drop the current search
+	bool sets = _config.storage != Config::STORAGE_DENSE || _dense_set != NULL;
+	vector<Map::Cell*> cells;
+	_cells(cells);
+
+	while ( ! _open_list->empty())
+	{
+		_list_remove(_open_list->top());
+	}
+
+	for (unsigned int i = 0; i < cells.size(); i++)
+	{
+		_g(cells[i], Cost<T>::inf());
+		_rhs(cells[i], pair<Map::Cell*,T>(NULL, Cost<T>::inf()));
+
+		if (sets)
+		{
+			*_set(cells[i]) = SET_NONE;
+		}
+	}
+
+	_closed.clear();
+	_incons.clear();
+	_path_clear();
+
+	delete _dense_cost;
+	_dense_cost = NULL;
+	_cost_hash.clear();
+
+	unsigned int cols = _map->cols();
+
+	for (unsigned int i = 0; i < m; i++)
+	{
+		_cell_cost((*_map)(cost_index[i] / cols, cost_index[i] % cols), cost_value[i]);
+	}
+
+	// A saved anytime search brings its sets along
+	if ( ! sets && header.epsilon > 1)
+	{
+		_dense_set = new unsigned char[_rows * _cols];
+		fill(_dense_set, _dense_set + _rows * _cols, (unsigned char) SET_NONE);
+	}
+
+	_start = (*_map)(header.start / cols, header.start % cols);
+	_goal = (*_map)(header.goal / cols, header.goal % cols);
+	_last = (*_map)(header.last / cols, header.last % cols);
+	_km = Cost<T>::from(header.km);
+	_epsilon = header.epsilon;
+	_bound = header.bound;
+	_rows = header.searched_rows;
+	_cols = header.searched_cols;
+	_suspended = header.suspended != 0;
+
+	cells.resize(n);
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		Map::Cell* u = (*_map)(index[i] / cols, index[i] % cols);
+		Map::Cell* s = (succ[i] != SNAPSHOT_NONE) ? (*_map)(succ[i] / cols, succ[i] % cols) : NULL;
+		unsigned char set = flags[i] & ~SNAPSHOT_OPEN;
+
+		_g(u, g[i]);
+		_rhs(u, pair<Map::Cell*,T>(s, rhs[i]));
+
+		// An inconsistent cell was closed first, _tighten() clears it through CLOSED
+		if (set == SET_CLOSED || set == SET_INCONS)
+		{
+			_closed.push_back(u);
+		}
+
+		if (set == SET_INCONS)
+		{
+			_incons.push_back(u);
+		}
+
+		if (set != SET_NONE)
+		{
+			*_set(u) = set;
+		}
+
+		cells[i] = u;
+	}
+
+	// km only covers the moves up to the last start, keys are taken from there
+	Map::Cell* start = _start;
+	_start = _last;
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		if (flags[i] & SNAPSHOT_OPEN)
+		{
+			_list_insert(cells[i], _k(cells[i]));
+		}
+	}
+
+	_start = start;
+
+	_path_stale = false;
+	_path_affected = true;
+
+	return true;
+}
+
+/**
+ * Gets the next cell on the path (a best guess while the search is suspended).
+ *
+ * @return  Map::Cell*   next cell (NULL at the goal or without a path)
+ */
+template <typename T, typename N>
+Map::Cell* BasicPlanner<T,N>::next_step()
+{
+	if (_start == _goal)
+		return NULL;
+
+	if ( ! _suspended)
+		return (_g(_start) == Cost<T>::inf()) ? NULL : *_succ(_start);
+
+	// Best guess on what the search has so far
+	pair<Map::Cell*,T> best = _min_succ(_start);
+
+	if (best.first != NULL)
+		return best.first;
+
+	Map::Cell* nbrs[N::SIZE];
+	unsigned int n = _map->nbrs<N>(_start, nbrs);
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		T cost = _cost(_start, nbrs[i]);
+
+		if (cost == Cost<T>::inf())
+			continue;
+
+		cost = Cost<T>::add(cost, _h(nbrs[i], _goal));
+
+		if (cost < best.second)
+		{
+			best = pair<Map::Cell*,T>(nbrs[i], cost);
+		}
+	}
+
+	return best.first;
+}
+
 /**
  * Replans the path.
  *
+ * The path itself is only walked when path() asks for it. When no update
+ * affected() the path, it is kept and only loses the cells behind the start.
+ * A search that runs out of budget is suspended() and resumed by the next call.
+ * After a finished anytime search, the next call lowers epsilon first.
+ *
  * @return  bool   solution found
  */
-bool Planner::replan()
+template <typename T, typename N>
+bool BasicPlanner<T,N>::replan()
 {
-	_path.clear();
+	// A new record for this replan
+	DSTARLITE_STAT(_stats_total.add(_stats);)
+	DSTARLITE_STAT(_stats = Stats();)
+
+	// The start may have moved since the last update (while the search was
+	// suspended), keep the queued keys lower bounds
+	_km = Cost<T>::add(_km, _inflate(_h(_last, _start)));
+	_last = _start;
+
+	if (_epsilon > 1 && _bound == _epsilon && _config.epsilon_step > 0)
+	{
+		_tighten();
+	}
+
+	// The route still holds (under the current bound), it only starts further along
+	if ( ! affected())
+	{
+		while (_path.front() != _start)
+		{
+			*_path_flag(_path.front()) = false;
+			_path.pop_front();
+		}
+
+		_bound = _epsilon;
+
+		return true;
+	}
+
+	_path_clear();
+	_path_stale = true;
+
+	if (_map->rows() != _rows || _map->cols() != _cols)
+	{
+		_grown();
+	}
+
+	DSTARLITE_STAT(double started = Timer::now();)
+	DSTARLITE_TRACE_COUNTER("open_list", _open_list->size());
 	
-	bool result = _compute();
+	bool result = _compute(_start);
+
+	// A cell of the path whose first key ties the start's but rounds one ulp
+	// higher can still be queued when the search stops, and its stale
+	// successor may lead back into the path; settle it the same way, which
+	// can change the start again
+	for (Map::Cell* u = _unsettled(); result && u != NULL; u = _unsettled())
+	{
+		result = _compute(u) && (_open_list->empty() || _compute(_start));
+	}
+
+	DSTARLITE_TRACE_COUNTER("open_list", _open_list->size());
+
+	DSTARLITE_STAT(_stats.compute_time += Timer::now() - started;)
 	
 	// Couldn't find a solution
 	if ( ! result)
 	  return false;
 
-	Map::Cell* current = _start;
-	_path.push_back(current);
+	_bound = _epsilon;
+
+	return _g(_start) != Cost<T>::inf();
+}
+
+/**
+ * Saves the search as a binary snapshot (see the format in planner.h).
+ *
+ * @param   char*   file name
+ * @return  bool    successful
+ */
+template <typename T, typename N>
+bool BasicPlanner<T,N>::save(const char* file)
+{
+	DSTARLITE_TRACE_SCOPE("save");
+
+	vector<Map::Cell*> cells;
+	_cells(cells);
+
+	// Cells are stored by their place in the map, pointers don't outlive the process
+	unsigned int cols = _map->cols();
+	unsigned int n = (unsigned int) cells.size();
+	bool sets = _config.storage != Config::STORAGE_DENSE || _dense_set != NULL;
 
-	// Follow the path with the least cost until goal is reached
-	while (current != _goal)
+	vector<uint32_t> index(n), succ(n);
+	vector<T> g(n), rhs(n);
+	vector<unsigned char> flags(n);
+
+	for (unsigned int i = 0; i < n; i++)
 	{
-		if (current == NULL || _g(current) == Math::INF)
-			return false;
+		Map::Cell* u = cells[i];
+		Map::Cell* s = *_succ(u);
 
-		current = _min_succ(current).first;
+		index[i] = u->y() * cols + u->x();
+		succ[i] = (s != NULL) ? s->y() * cols + s->x() : SNAPSHOT_NONE;
+		g[i] = _g(u);
+		rhs[i] = _rhs(u);
+		flags[i] = sets ? *_set(u) : (unsigned char) SET_NONE;
 
-		_path.push_back(current);
+		if (*_pos(u) != OL::NONE)
+		{
+			flags[i] |= SNAPSHOT_OPEN;
+		}
 	}
 
-	return true;
-}
+	// Only the costs the planner changed, the map has the rest
+	vector<uint32_t> cost_index;
+	vector<double> cost_value;
 
-/**
- * Gets/Sets start.
+	if (_dense_cost != NULL)
+	{
+		Map::Cell* first = (*_map)(0, 0);
+
+		for (unsigned int i = 0; i < _rows * _cols; i++)
+		{
+			double cost = _dense_cost->get(i);
+
+			if (cost != _map->cost(first + i))
+			{
+				cost_index.push_back(i);
+				cost_value.push_back(cost);
+			}
+		}
+	}
+
+	for (typename CC::iterator i = _cost_hash.begin(); i != _cost_hash.end(); ++i)
+	{
+		cost_index.push_back(i->first->y() * cols + i->first->x());
+		cost_value.push_back(i->second);
+	}
+
+	unsigned int m = (unsigned int) cost_index.size();
+	T inf = Cost<T>::inf();
+
+	Snapshot header;
+	memset(&header, 0, sizeof(Snapshot));
+	memcpy(header.magic, "DSLP", 4);
+	header.version = SNAPSHOT_VERSION;
+	header.order = SNAPSHOT_ORDER;
+	header.cost = sizeof(T);
+	header.neighborhood = N::SIZE;
+	header.rows = _map->rows();
+	header.cols = cols;
+	header.searched_rows = _rows;
+	header.searched_cols = _cols;
+	header.start = _start->y() * cols + _start->x();
+	header.goal = _goal->y() * cols + _goal->x();
+	header.last = _last->y() * cols + _last->x();
+	header.cells = n;
+	header.costs = m;
+	header.suspended = _suspended ? 1 : 0;
+	header.checksum = _map->checksum();
+	memcpy(header.inf, &inf, sizeof(T));
+	header.km = Cost<T>::to(_km);
+	header.epsilon = _epsilon;
+	header.bound = _bound;
+
+	FILE* fp = fopen(file, "wb");
+	bool result = false;
+
+	if (fp != NULL)
+	{
+		result = fwrite(&header, sizeof(Snapshot), 1, fp) == 1;
+
+		if (result && n > 0)
+		{
+			result = fwrite(&index[0], sizeof(uint32_t), n, fp) == n
+				&& fwrite(&succ[0], sizeof(uint32_t), n, fp) == n
+				&& fwrite(&g[0], sizeof(T), n, fp) == n
+				&& fwrite(&rhs[0], sizeof(T), n, fp) == n
+				&& fwrite(&flags[0], 1, n, fp) == n;
+		}
+
+		if (result && m > 0)
+		{
+			result = fwrite(&cost_index[0], sizeof(uint32_t), m, fp) == m
+				&& fwrite(&cost_value[0], sizeof(double), m, fp) == m;
+		}
+
+		result = (fclose(fp) == 0) && result;
+	}
+
+	return result;
+}
+
+/**
+ * Gets/Sets start.
  *
  * @param   Map::Cell* [optional]   new start
  * @return  Map::Cell*              start
  */
-Map::Cell* Planner::start(Map::Cell* u)
+template <typename T, typename N>
+Map::Cell* BasicPlanner<T,N>::start(Map::Cell* u)
+{
+	if (u == NULL)
+		return _start;
+
+	_start = u;
+
+	return _start;
+}
+
+/**
+ * Gets the statistics since the last replan() started (the replan, the
+ * path built after it, and any updates since).
+ *
+ * @return  Stats
+ */
+template <typename T, typename N>
+const typename BasicPlanner<T,N>::Stats& BasicPlanner<T,N>::stats()
+{
+	return _stats;
+}
+
+/**
+ * Resets the statistics.
+ *
+ * @return  void
+ */
+template <typename T, typename N>
+void BasicPlanner<T,N>::stats_reset()
+{
+	_stats = Stats();
+	_stats_total = Stats();
+}
+
+/**
+ * Gets the statistics since construction or stats_reset().
+ *
+ * @return  Stats
+ */
+template <typename T, typename N>
+typename BasicPlanner<T,N>::Stats BasicPlanner<T,N>::stats_total()
+{
+	Stats total = _stats_total;
+	total.add(_stats);
+
+	return total;
+}
+
+/**
+ * Determines if the last replan() ran out of budget before it finished.
+ *
+ * @return  bool
+ */
+template <typename T, typename N>
+bool BasicPlanner<T,N>::suspended()
+{
+	return _suspended;
+}
+
+/**
+ * Update map.
+ *
+ * @param   Map::Cell*   cell to update
+ * @param   double       new cost of the cell
+ * @return  void
+ */
+template <typename T, typename N>
+void BasicPlanner<T,N>::update(Map::Cell* u, double cost)
+{
+	DSTARLITE_TRACE_SCOPE("update");
+
+	if (u == _goal)
+		return;
+
+	// Moves passing beside u change too, let the batch update find them
+	if (N::CROSSING)
+	{
+		update_batch(vector<pair<Map::Cell*,double> >(1, pair<Map::Cell*,double>(u, cost)));
+		return;
+	}
+
+	// Update km
+	_km = Cost<T>::add(_km, _inflate(_h(_last, _start)));
+	_last = _start;
+
+	Map::Cell* nbrs[N::SIZE];
+	unsigned int n = _map->nbrs<N>(u, nbrs);
+
+	_path_touch(u);
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		_path_touch(nbrs[i]);
+	}
+
+	// Edge costs before and after the change
+	T costs_old[N::SIZE];
+	T costs_new[N::SIZE];
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		costs_old[i] = _cost(u, nbrs[i]);
+	}
+
+	_cell_cost(u, cost);
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		costs_new[i] = _cost(u, nbrs[i]);
+	}
+
+	T tmp_rhs, tmp_g;
+
+	// Update u
+	for (unsigned int i = 0; i < n; i++)
+	{
+		tmp_rhs = _rhs(u);
+		tmp_g = _g(nbrs[i]);
+
+		if (Cost<T>::greater(costs_old[i], costs_new[i]))
+		{
+			if (u != _goal && Cost<T>::add(costs_new[i], tmp_g) < tmp_rhs)
+			{
+				_rhs(u, pair<Map::Cell*,T>(nbrs[i], Cost<T>::add(costs_new[i], tmp_g)));
+			}
+		}
+		else if (Cost<T>::equals(tmp_rhs, Cost<T>::add(costs_old[i], tmp_g)))
+		{
+			if (u != _goal)
+			{
+				_rhs(u, _min_succ(u));
+			}
+		}
+	}
+
+	_update(u);
+
+	// Update neighbors
+	for (unsigned int i = 0; i < n; i++)
+	{
+		tmp_rhs = _rhs(nbrs[i]);
+		tmp_g = _g(u);
+
+		if (Cost<T>::greater(costs_old[i], costs_new[i]))
+		{
+			if (nbrs[i] != _goal && Cost<T>::add(costs_new[i], tmp_g) < tmp_rhs)
+			{
+				_rhs(nbrs[i], pair<Map::Cell*,T>(u, Cost<T>::add(costs_new[i], tmp_g)));
+			}
+		}
+		else if (Cost<T>::equals(tmp_rhs, Cost<T>::add(costs_old[i], tmp_g)))
+		{
+			if (nbrs[i] != _goal)
+			{
+				_rhs(nbrs[i], _min_succ(nbrs[i]));
+			}
+		}
+
+		_update(nbrs[i]);
+	}
+}
+
+/**
+ * Update map with many cells at once.
+ *
+ * @param   vector<pair<Map::Cell*,double> >   cells to update and their new costs
+ * @return  void
+ */
+template <typename T, typename N>
+void BasicPlanner<T,N>::update_batch(const vector<pair<Map::Cell*,double> >& changes)
+{
+	if (changes.empty())
+		return;
+
+	DSTARLITE_TRACE_SCOPE("update_batch");
+
+	// Update km
+	_km = Cost<T>::add(_km, _inflate(_h(_last, _start)));
+	_last = _start;
+
+	// Coalesce, the stable sort keeps the last change to a cell at the end of its run
+	vector<pair<Map::Cell*,double> > sorted(changes);
+	stable_sort(sorted.begin(), sorted.end(), CellLess());
+
+	vector<Map::Cell*> affected;
+	affected.reserve(sorted.size() * (N::SIZE + 1));
+
+	for (unsigned int i = 0; i < sorted.size(); i++)
+	{
+		Map::Cell* u = sorted[i].first;
+
+		if (i + 1 < sorted.size() && sorted[i + 1].first == u)
+			continue;
+
+		if (u == _goal || _cell_cost(u) == sorted[i].second)
+			continue;
+
+		_cell_cost(u, sorted[i].second);
+
+		// Every edge touching u (or passing beside it) changed, so u and its
+		// neighbors need a new rhs
+		affected.push_back(u);
+
+		Map::Cell* nbrs[N::SIZE];
+		unsigned int n = _map->nbrs<N>(u, nbrs);
+
+		for (unsigned int j = 0; j < n; j++)
+		{
+			affected.push_back(nbrs[j]);
+		}
+	}
+
+	sort(affected.begin(), affected.end());
+	affected.erase(unique(affected.begin(), affected.end()), affected.end());
+
+	for (unsigned int i = 0; i < affected.size(); i++)
+	{
+		_path_touch(affected[i]);
+
+		if (affected[i] != _goal)
+		{
+			_rhs(affected[i], _min_succ(affected[i]));
+		}
+
+		_update(affected[i]);
+	}
+}
+
+/**
+ * Generates a cell.
+ *
+ * @param   Map::Cell*
+ * @return  State*
+ */
+template <typename T, typename N>
+typename BasicPlanner<T,N>::State* BasicPlanner<T,N>::_cell(Map::Cell* u)
+{
+	if (_config.storage == Config::STORAGE_TILED)
+	{
+		unsigned int tile, offset;
+		_map->locate(u, &tile, &offset);
+
+		if (tile >= _tiles.size())
+		{
+			_tiles.resize(tile + 1, NULL);
+		}
+
+		if (_tiles[tile] == NULL)
+		{
+			unsigned int n = _map->tile_size() * _map->tile_size();
+
+			_tiles[tile] = new State[n];
+
+			DSTARLITE_STAT(_stats.cells += n;)
+
+			for (unsigned int i = 0; i < n; i++)
+			{
+				_tiles[tile][i].g = Cost<T>::inf();
+				_tiles[tile][i].rhs = Cost<T>::inf();
+				_tiles[tile][i].pos = OL::NONE;
+				_tiles[tile][i].set = SET_NONE;
+				_tiles[tile][i].path = false;
+				_tiles[tile][i].succ = NULL;
+			}
+
+			// Map tiles keep their cells contiguous in the same order
+			_tile_cells.resize(_tiles.size(), NULL);
+			_tile_cells[tile] = u - offset;
+		}
+
+		return &_tiles[tile][offset];
+	}
+
+	typename CH::iterator i = _cell_hash.find(u);
+
+	if (i != _cell_hash.end())
+		return &i->second;
+	
+	State* s = &_cell_hash[u];
+
+	DSTARLITE_STAT(_stats.cells++;)
+	s->g = Cost<T>::inf();
+	s->rhs = Cost<T>::inf();
+	s->pos = OL::NONE;
+	s->set = SET_NONE;
+	s->path = false;
+	s->succ = NULL;
+
+	return s;
+}
+
+/**
+ * Gets the cost of a cell.
+ *
+ * @param   Map::Cell*   cell
+ * @return  double       cost
+ */
+template <typename T, typename N>
+double BasicPlanner<T,N>::_cell_cost(Map::Cell* u)
+{
+	if (_dense_cost != NULL)
+		return _dense_cost->get(_id(u));
+
+	if ( ! _cost_hash.empty())
+	{
+		typename CC::iterator i = _cost_hash.find(u);
+
+		if (i != _cost_hash.end())
+			return i->second;
+	}
+
+	return _map->cost(u);
+}
+
+/**
+ * Sets the cost of a cell (the map is left alone).
+ *
+ * @param   Map::Cell*   cell
+ * @param   double       new cost
+ * @return  void
+ */
+template <typename T, typename N>
+void BasicPlanner<T,N>::_cell_cost(Map::Cell* u, double cost)
+{
+	if (_config.storage != Config::STORAGE_DENSE)
+	{
+		_cost_hash[u] = cost;
+		return;
+	}
+
+	// Copy the map on the first update (in the map's format)
+	if (_dense_cost == NULL)
+	{
+		_dense_cost = new CostLayer(*_map->costs());
+	}
+
+	_dense_cost->set(_id(u), cost);
+}
+
+/**
+ * Lists every cell with a g or rhs value.
+ *
+ * @param   vector<Map::Cell*>&   cells
+ * @return  void
+ */
+template <typename T, typename N>
+void BasicPlanner<T,N>::_cells(vector<Map::Cell*>& cells)
+{
+	if (_config.storage == Config::STORAGE_DENSE)
+	{
+		// Contiguous maps keep their cells in index order
+		Map::Cell* first = (*_map)(0, 0);
+		unsigned int n = _rows * _cols;
+
+		for (unsigned int i = 0; i < n; i++)
+		{
+			if (_dense_g[i] != Cost<T>::inf() || _dense_rhs[i] != Cost<T>::inf())
+			{
+				cells.push_back(first + i);
+			}
+		}
+	}
+	else if (_config.storage == Config::STORAGE_TILED)
+	{
+		unsigned int n = _map->tile_size() * _map->tile_size();
+
+		for (unsigned int i = 0; i < _tiles.size(); i++)
+		{
+			if (_tiles[i] == NULL)
+				continue;
+
+			for (unsigned int j = 0; j < n; j++)
+			{
+				if (_tiles[i][j].g != Cost<T>::inf() || _tiles[i][j].rhs != Cost<T>::inf())
+				{
+					cells.push_back(_tile_cells[i] + j);
+				}
+			}
+		}
+	}
+	else
+	{
+		for (typename CH::iterator i = _cell_hash.begin(); i != _cell_hash.end(); ++i)
+		{
+			if (i->second.g != Cost<T>::inf() || i->second.rhs != Cost<T>::inf())
+			{
+				cells.push_back(i->first);
+			}
+		}
+	}
+}
+
+/**
+ * Computes shortest path.
+ *
+ * @param   Map::Cell*   cell to settle (the start, or a queued cell of its path)
+ * @return  bool         successful
+ */
+template <typename T, typename N>
+bool BasicPlanner<T,N>::_compute(Map::Cell* target)
+{
+	DSTARLITE_TRACE_SCOPE("compute");
+
+	_suspended = false;
+
+	if (_open_list->empty())
+		return false;
+
+	KeyCompare key_compare;
+
+	int attempts = 0;
+	unsigned long expanded = 0;
+
+	// Out of budget the search stops with every inconsistent cell still
+	// queued, so the next call picks up where this one left off
+	unsigned long budget = _config.budget_expansions;
+	double deadline = (_config.budget_time > 0) ? Timer::now() + _config.budget_time : 0;
+
+	Map::Cell* u;
+	Key k_old;
+	Key k_new;
+	Map::Cell* nbrs[N::SIZE];
+	unsigned int n;
+	T g_old;
+	T tmp_g, tmp_rhs;
+
+	while (( ! _open_list->empty() && key_compare(_open_list->top_key(), _k(target))) || ! Cost<T>::equals(_rhs(target), _g(target)))
+	{
+		// An improved start may wait in INCONS (see _update()), it is left
+		// for the next bound once nothing queued comes before it
+		if (_open_list->empty())
+			break;
+
+		if (_epsilon > 1 && *_set(_start) == SET_INCONS && _rhs(_start) < _g(_start) && ! key_compare(_open_list->top_key(), _k(_start)))
+			break;
+
+		// Reached max steps, quit
+		if (++attempts > MAX_STEPS)
+			return false;
+
+		if (budget != 0 && expanded >= budget)
+		{
+			_suspended = true;
+			return false;
+		}
+
+		// The clock is only read every 32 iterations
+		if (deadline != 0 && (attempts & 31) == 0 && Timer::now() > deadline)
+		{
+			_suspended = true;
+			return false;
+		}
+
+		u = _open_list->top();
+		k_old = _open_list->top_key();
+		k_new = _k(u);
+
+		tmp_rhs = _rhs(u);
+		tmp_g = _g(u);
+		
+		// A stale key is only refreshed, that is no expansion
+		if (key_compare(k_old, k_new))
+		{
+			_list_update(u, k_new);
+		}
+		else if (Cost<T>::greater(tmp_g, tmp_rhs))
+		{
+			DSTARLITE_STAT(_stats.expansions_over++;)
+
+			_expansions++;
+			expanded++;
+
+			_g(u, tmp_rhs);
+			tmp_g = tmp_rhs;
+
+			_list_remove(u);
+
+			if (_epsilon > 1)
+			{
+				*_set(u) = SET_CLOSED;
+				_closed.push_back(u);
+			}
+
+			n = _map->nbrs<N>(u, nbrs);
+
+			for (unsigned int i = 0; i < n; i++)
+			{
+				if (nbrs[i] != _goal)
+				{
+					tmp_rhs = Cost<T>::add(_cost(nbrs[i], u), tmp_g);
+
+					if (tmp_rhs < _rhs(nbrs[i]))
+					{
+						_rhs(nbrs[i], pair<Map::Cell*,T>(u, tmp_rhs));
+					}
+				}
+
+				_update(nbrs[i]);
+			}
+		}
+		else
+		{
+			DSTARLITE_STAT(_stats.expansions_under++;)
+
+			_expansions++;
+			expanded++;
+
+			g_old = tmp_g;
+			_g(u, Cost<T>::inf());
+
+			// Perform action for u
+			if (u != _goal)
+			{
+				_rhs(u, _min_succ(u));
+			}
+
+			_update(u);
+
+			n = _map->nbrs<N>(u, nbrs);
+
+			// Perform action for neighbors
+			for (unsigned int i = 0; i < n; i++)
+			{
+				if (Cost<T>::equals(_rhs(nbrs[i]), Cost<T>::add(_cost(nbrs[i], u), g_old)))
+				{
+					if (nbrs[i] != _goal)
+					{
+						_rhs(nbrs[i], _min_succ(nbrs[i]));
+					}
+				}
+
+				_update(nbrs[i]);
+			}
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Calculates the cost from one cell to another cell.
+ * 
+ * @param   Map::Cell*   cell a
+ * @param   Map::Cell*   cell b
+ * @return  T            cost between a and b
+ */
+template <typename T, typename N>
+T BasicPlanner<T,N>::_cost(Map::Cell* a, Map::Cell* b)
+{
+	double cost_a = _cell_cost(a);
+	double cost_b = _cell_cost(b);
+
+	if (cost_a == Map::Cell::COST_UNWALKABLE || cost_b == Map::Cell::COST_UNWALKABLE)
+		return Cost<T>::inf();
+
+	// Coordinates are unsigned, take the differences as signed ints
+	int sx = (int) b->x() - (int) a->x();
+	int sy = (int) b->y() - (int) a->y();
+	unsigned int dx = abs(sx);
+	unsigned int dy = abs(sy);
+
+	// Knight move, also pays for the two cells it passes between
+	if (N::CROSSING && (dx + dy) == 3)
+	{
+		Map::Cell* m1;
+		Map::Cell* m2;
+
+		if (dy == 2)
+		{
+			m1 = (*_map)(a->y() + sy / 2, a->x());
+			m2 = (*_map)(a->y() + sy / 2, b->x());
+		}
+		else
+		{
+			m1 = (*_map)(a->y(), a->x() + sx / 2);
+			m2 = (*_map)(b->y(), a->x() + sx / 2);
+		}
+
+		double cost_m1 = _cell_cost(m1);
+		double cost_m2 = _cell_cost(m2);
+
+		if (cost_m1 == Map::Cell::COST_UNWALKABLE || cost_m2 == Map::Cell::COST_UNWALKABLE)
+			return Cost<T>::inf();
+
+		return Cost<T>::from(Math::SQRT5 * ((cost_a + cost_b + cost_m1 + cost_m2) / 4));
+	}
+
+	double scale = 1.0;
+
+	if ((dx + dy) > 1)
+	{
+		scale = Math::SQRT2;
+	}
+
+	return Cost<T>::from(scale * ((cost_a + cost_b) / 2));
+}
+
+/**
+ * Gets g value for a cell.
+ * 
+ * @param   Map::Cell*   cell to retrieve
+ * @return  T            g value 
+ */
+template <typename T, typename N>
+T BasicPlanner<T,N>::_g(Map::Cell* u)
+{
+	return (_dense_g != NULL) ? _dense_g[_id(u)] : _cell(u)->g;
+}
+
+/**
+ * Sets g value for a cell.
+ * 
+ * @param   Map::Cell*   cell to update
+ * @param   T            new g value
+ * @return  T            g value 
+ */
+template <typename T, typename N>
+T BasicPlanner<T,N>::_g(Map::Cell* u, T value)
+{
+	T* g = (_dense_g != NULL) ? &_dense_g[_id(u)] : &_cell(u)->g;
+	*g = value;
+
+	return *g;
+}
+
+/**
+ * Gets the dense index of a cell.
+ *
+ * @param   Map::Cell*     cell
+ * @return  unsigned int   row * cols + col
+ */
+template <typename T, typename N>
+unsigned int BasicPlanner<T,N>::_id(Map::Cell* u)
+{
+	return _map->index(u);
+}
+
+/**
+ * Brings the cells along the old edges up to date after the map grew.
+ *
+ * New cells have no g value yet, so only the ones within reach of an old
+ * cell need a new rhs; the search carries it on from there.
+ *
+ * @return  void
+ */
+template <typename T, typename N>
+void BasicPlanner<T,N>::_grown()
+{
+	unsigned int rows = _map->rows();
+	unsigned int cols = _map->cols();
+
+	for (unsigned int y = 0; y < _rows; y++)
+	{
+		// Columns past the old right edge
+		for (unsigned int x = _cols; x < cols && x < _cols + N::RADIUS; x++)
+		{
+			Map::Cell* u = (*_map)(y, x);
+
+			_rhs(u, _min_succ(u));
+			_update(u);
+		}
+	}
+
+	for (unsigned int y = _rows; y < rows && y < _rows + N::RADIUS; y++)
+	{
+		// Rows past the old bottom edge
+		for (unsigned int x = 0; x < cols && x < _cols + N::RADIUS; x++)
+		{
+			Map::Cell* u = (*_map)(y, x);
+
+			_rhs(u, _min_succ(u));
+			_update(u);
+		}
+	}
+
+	_rows = rows;
+	_cols = cols;
+	_path_affected = true;
+}
+
+/**
+ * Calculates heuristic between two cells (distance under the neighborhood).
+ *
+ * @param   Map::Cell*   cell a
+ * @param   Map::Cell*   cell b
+ * @return  T            heuristic value
+ */
+template <typename T, typename N>
+T BasicPlanner<T,N>::_h(Map::Cell* a, Map::Cell* b)
+{
+	unsigned int dx = abs((int) a->x() - (int) b->x());
+	unsigned int dy = abs((int) a->y() - (int) b->y());
+
+	return N::template h<T>(dx, dy);
+}
+
+/**
+ * Weighs a heuristic value by the current epsilon.
+ *
+ * @param   T   heuristic value
+ * @return  T   weighted value
+ */
+template <typename T, typename N>
+T BasicPlanner<T,N>::_inflate(T h)
+{
+	if (_epsilon == 1)
+		return h;
+
+	return Cost<T>::from(Cost<T>::to(h) * _epsilon);
+}
+
+/**
+ * Calculates key value for cell.
+ *
+ * Overconsistent cells are keyed on the weighted heuristic, so the search
+ * heads for the start first (Anytime D*); underconsistent ones keep the
+ * plain heuristic.
+ *
+ * @param   Map::Cell*   cell to calculate for
+ * @return  Key          key value
+ */
+template <typename T, typename N>
+typename BasicPlanner<T,N>::Key BasicPlanner<T,N>::_k(Map::Cell* u)
+{
+	T g = _g(u);
+	T rhs = _rhs(u);
+
+	if (_epsilon > 1 && rhs < g)
+		return Cost<T>::key(Cost<T>::add(Cost<T>::add(rhs, _inflate(_h(_start, u))), _km), rhs);
+
+	T min = (g < rhs) ? g : rhs;
+	return Cost<T>::key(Cost<T>::add(Cost<T>::add(min, _h(_start, u)), _km), min);
+}
+
+/**
+ * Inserts cell into open list.
+ *
+ * @param   Map::Cell*   cell to insert
+ * @param   Key          key vakue for the cell
+ * @return  void
+ */
+template <typename T, typename N>
+void BasicPlanner<T,N>::_list_insert(Map::Cell* u, Key k)
+{
+	_open_list->insert(u, k, _pos(u));
+
+	DSTARLITE_STAT(_stats.inserts++;)
+	DSTARLITE_STAT(_stats.open_peak = max(_stats.open_peak, (unsigned long) _open_list->size());)
+}
+
+/**
+ * Removes cell from the open list.
+ *
+ * @param   Map::Cell*   cell to remove
+ * @return  void
+ */
+template <typename T, typename N>
+void BasicPlanner<T,N>::_list_remove(Map::Cell* u)
+{
+	_open_list->remove(_pos(u));
+
+	DSTARLITE_STAT(_stats.removes++;)
+}
+
+/**
+ * Updates cell in the open list.
+ *
+ * @param   Map::Cell*
+ * @param   Key
+ * @return  void
+ */
+template <typename T, typename N>
+void BasicPlanner<T,N>::_list_update(Map::Cell* u, Key k)
+{
+	_open_list->update(_pos(u), k);
+
+	DSTARLITE_STAT(_stats.updates++;)
+}
+
+/**
+ * Finds the minimum successor cell.
+ *
+ * @param   Map::Cell*       root
+ * @return  <Map::Cell*,T>   successor
+ */
+template <typename T, typename N>
+pair<Map::Cell*,T> BasicPlanner<T,N>::_min_succ(Map::Cell* u)
+{
+	DSTARLITE_STAT(_stats.min_succ++;)
+
+	Map::Cell* nbrs[N::SIZE];
+	unsigned int n = _map->nbrs<N>(u, nbrs);
+
+	T tmp_cost, tmp_g;
+	
+	Map::Cell* min_cell = NULL;
+	T min_cost = Cost<T>::inf();
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		tmp_cost = _cost(u, nbrs[i]);
+		tmp_g = _g(nbrs[i]);
+
+		if (tmp_cost == Cost<T>::inf() || tmp_g == Cost<T>::inf())
+			continue;
+		
+		tmp_cost = Cost<T>::add(tmp_cost, tmp_g);
+
+		if (tmp_cost < min_cost)
+		{
+			min_cell = nbrs[i];
+			min_cost = tmp_cost;
+		}
+	}
+
+	return pair<Map::Cell*,T>(min_cell, min_cost);
+}
+
+/**
+ * Clears the path and its flags.
+ *
+ * @return  void
+ */
+template <typename T, typename N>
+void BasicPlanner<T,N>::_path_clear()
+{
+	for (list<Map::Cell*>::iterator i = _path.begin(); i != _path.end(); ++i)
+	{
+		*_path_flag(*i) = false;
+	}
+
+	_path.clear();
+}
+
+/**
+ * Gets the path flag of a cell.
+ *
+ * @param   Map::Cell*   cell
+ * @return  bool*        on the current path
+ */
+template <typename T, typename N>
+bool* BasicPlanner<T,N>::_path_flag(Map::Cell* u)
+{
+	return (_dense_path != NULL) ? &_dense_path[_id(u)] : &_cell(u)->path;
+}
+
+/**
+ * Marks the path affected if a cell about to change is on it.
+ *
+ * @param   Map::Cell*   cell
+ * @return  void
+ */
+template <typename T, typename N>
+void BasicPlanner<T,N>::_path_touch(Map::Cell* u)
+{
+	if (*_path_flag(u))
+	{
+		_path_affected = true;
+	}
+}
+
+/**
+ * Gets the open list position of a cell.
+ *
+ * @param   Map::Cell*      cell
+ * @return  unsigned int*   position
+ */
+template <typename T, typename N>
+unsigned int* BasicPlanner<T,N>::_pos(Map::Cell* u)
+{
+	return (_dense_pos != NULL) ? &_dense_pos[_id(u)] : &_cell(u)->pos;
+}
+
+/**
+ * Gets rhs value for a cell.
+ * 
+ * @param   Map::Cell*   cell to retrieve
+ * @return  T            rhs value
+ */
+template <typename T, typename N>
+T BasicPlanner<T,N>::_rhs(Map::Cell* u)
+{
+	if (u == _goal)
+		return 0;
+
+	return (_dense_rhs != NULL) ? _dense_rhs[_id(u)] : _cell(u)->rhs;
+}
+
+/**
+ * Sets rhs value for a cell.
+ * 
+ * @param   Map::Cell*   cell to update
+ * @param   T            new rhs value
+ * @return  T            rhs value
+ */
+template <typename T, typename N>
+T BasicPlanner<T,N>::_rhs(Map::Cell* u, T value)
+{
+	if (u == _goal)
+		return 0;
+
+	T* rhs = (_dense_rhs != NULL) ? &_dense_rhs[_id(u)] : &_cell(u)->rhs;
+	*rhs = value;
+	
+	return *rhs;
+}
+
+/**
+ * Sets rhs value and successor for a cell.
+ * 
+ * @param   Map::Cell*           cell to update
+ * @param   pair<Map::Cell*,T>   successor and new rhs value
+ * @return  T                    rhs value
+ */
+template <typename T, typename N>
+T BasicPlanner<T,N>::_rhs(Map::Cell* u, pair<Map::Cell*,T> succ)
 {
-	if (u == NULL)
-		return _start;
+	*_succ(u) = succ.first;
 
-	_start = u;
-
-	return _start;
+	return _rhs(u, succ.second);
 }
 
 /**
- * Update map.
+ * Moves the goal, keeping the part of the search tree that still holds.
  *
- * @param   Map::Cell*   cell to update
- * @param   double       new cost of the cell
+ * The search runs from the goal, so a new goal is a new root (Moving Target
+ * D* Lite). Cells whose successors lead through the new goal keep their
+ * tree, their g values only drop by the new goal's old g value (a part of
+ * a shortest path is still one), and are summed again along the tree so
+ * they match the move costs exactly. Every other cell is reset, the ones along
+ * the kept tree are reseeded from it, and the next search repairs the rest.
+ * Every key is recomputed, so km starts over.
+ *
+ * @param   Map::Cell*   new goal
  * @return  void
  */
-void Planner::update(Map::Cell* u, double cost)
+template <typename T, typename N>
+void BasicPlanner<T,N>::_retarget(Map::Cell* u)
 {
-	if (u == _goal)
-		return;
-
-	// Update km
-	_km += _h(_last, _start);
-	_last = _start;
+	DSTARLITE_TRACE_SCOPE("retarget");
 
-	_cell(u);
+	vector<Map::Cell*> cells;
+	_cells(cells);
 
-	double cost_old = u->cost;
-	double cost_new = cost;
-	u->cost = cost;
-
-	Map::Cell** nbrs = u->nbrs();
+	// Goal moves mark cells in the sets
+	if (_config.storage == Config::STORAGE_DENSE && _dense_set == NULL)
+	{
+		_dense_set = new unsigned char[_rows * _cols];
+		fill(_dense_set, _dense_set + _rows * _cols, (unsigned char) SET_NONE);
+	}
 
-	double tmp_cost_old, tmp_cost_new;
-	double tmp_rhs, tmp_g;
+	while ( ! _open_list->empty())
+	{
+		_list_remove(_open_list->top());
+	}
 
-	// Update u
-	for (unsigned int i = 0; i < Map::Cell::NUM_NBRS; i++)
+	for (unsigned int i = 0; i < _closed.size(); i++)
 	{
-		if (nbrs[i] != NULL)
-		{
-			u->cost = cost_old;
-			tmp_cost_old = _cost(u, nbrs[i]);
-			u->cost = cost_new;
-			tmp_cost_new = _cost(u, nbrs[i]);
+		*_set(_closed[i]) = SET_NONE;
+	}
 
-			tmp_rhs = _rhs(u);
-			tmp_g = _g(nbrs[i]);
+	_closed.clear();
+	_incons.clear();
 
-			if (Math::greater(tmp_cost_old, tmp_cost_new))
-			{
-				if (u != _goal)
-				{
-					_rhs(u, min(tmp_rhs, (tmp_cost_new + tmp_g)));
-				}
-			}
-			else if (Math::equals(tmp_rhs, (tmp_cost_old + tmp_g)))
-			{
-				if (u != _goal)
-				{
-					_rhs(u, _min_succ(u).second);
-				}
-			}
-		}
-	}
+	// The subtree of the new goal, found by walking successors (every cell
+	// on a walk shares its answer, a cell on the walk ends a cycle)
+	T root = _g(u);
 
-	_update(u);
+	*_set(_goal) = SET_DROPPED;
+	*_set(u) = (root != Cost<T>::inf()) ? SET_KEPT : SET_DROPPED;
 
-	// Update neighbors
-	for (unsigned int i = 0; i < Map::Cell::NUM_NBRS; i++)
+	Map::Cell* old = _goal;
+	vector<Map::Cell*> walk;
+
+	for (unsigned int i = 0; i < cells.size(); i++)
 	{
-		if (nbrs[i] != NULL)
+		Map::Cell* v = cells[i];
+		unsigned char set = SET_DROPPED;
+
+		walk.clear();
+
+		while (*_set(v) == SET_NONE)
 		{
-			u->cost = cost_old;
-			tmp_cost_old = _cost(u, nbrs[i]);
-			u->cost = cost_new;
-			tmp_cost_new = _cost(u, nbrs[i]);
+			*_set(v) = SET_DROPPED;
+			walk.push_back(v);
 
-			tmp_rhs = _rhs(nbrs[i]);
-			tmp_g = _g(u);
+			// Only a consistent cell hangs in the tree
+			T g = _g(v);
 
-			if (Math::greater(tmp_cost_old, tmp_cost_new))
-			{
-				if (nbrs[i] != _goal)
-				{
-					_rhs(nbrs[i], min(tmp_rhs, (tmp_cost_new + tmp_g)));
-				}
-			}
-			else if (Math::equals(tmp_rhs, (tmp_cost_old + tmp_g)))
-			{
-				if (nbrs[i] != _goal)
-				{
-					_rhs(nbrs[i], _min_succ(nbrs[i]).second);
-				}
-			}
+			if (g == Cost<T>::inf() || g != _rhs(v) || *_succ(v) == NULL)
+				break;
+
+			v = *_succ(v);
+		}
+
+		if ( ! walk.empty() && *_set(v) == SET_KEPT)
+		{
+			set = SET_KEPT;
+		}
 
-			_update(nbrs[i]);
+		for (unsigned int j = 0; j < walk.size(); j++)
+		{
+			*_set(walk[j]) = set;
 		}
 	}
-}
 
-/**
- * Generates a cell.
- *
- * @param   Map::Cell*
- * @return  void
- */
-void Planner::_cell(Map::Cell* u)
-{
-	if (_cell_hash.find(u) != _cell_hash.end())
-		return;
-	
-	double h = Math::INF;
-	_cell_hash[u] = pair<double,double>(h, h);
-}
+	_goal = u;
 
-/**
- * Computes shortest path.
- *
- * @return  bool   successful
- */
-bool Planner::_compute()
-{
-	if (_open_list.empty())
-		return false;
+	vector<Map::Cell*> kept;
 
-	KeyCompare key_compare;
+	for (unsigned int i = 0; i < cells.size(); i++)
+	{
+		Map::Cell* v = cells[i];
 
-	int attempts = 0;
+		if (*_set(v) == SET_KEPT)
+		{
+			kept.push_back(v);
+		}
+		else if (*_set(v) == SET_DROPPED)
+		{
+			_g(v, Cost<T>::inf());
+			_rhs(v, pair<Map::Cell*,T>(NULL, Cost<T>::inf()));
 
-	Map::Cell* u;
-	pair<double,double> k_old;
-	pair<double,double> k_new;
-	Map::Cell** nbrs;
-	double g_old;
-	double tmp_g, tmp_rhs;
+			*_set(v) = SET_NONE;
+		}
+	}
 
-	while (( ! _open_list.empty() && key_compare(_open_list.begin()->first, _k(_start))) || ! Math::equals(_rhs(_start), _g(_start)))
+	// The kept values are rebuilt from the new goal down, each as the move
+	// cost plus the successor's g, exactly the sum the search compares
+	// against (subtracting the old root rounds differently); a walk stops at
+	// the first cell already done, which is marked CLOSED meanwhile. A new
+	// goal the old search never reached starts over as the only root
+	_g(_goal, kept.empty() ? Cost<T>::inf() : (T) 0);
+	_rhs(_goal, pair<Map::Cell*,T>(NULL, (T) 0));
+	*_set(_goal) = SET_CLOSED;
+
+	for (unsigned int i = 0; i < kept.size(); i++)
 	{
-		// Reached max steps, quit
-		if (++attempts > Planner::MAX_STEPS)
-			return false;
+		Map::Cell* v = kept[i];
 
-		u = _open_list.begin()->second;
-		k_old = _open_list.begin()->first;
-		k_new = _k(u);
+		walk.clear();
 
-		tmp_rhs = _rhs(u);
-		tmp_g = _g(u);
-		
-		if (key_compare(k_old, k_new))
+		while (*_set(v) == SET_KEPT)
 		{
-			_list_update(u, k_new);
+			walk.push_back(v);
+			v = *_succ(v);
 		}
-		else if (Math::greater(tmp_g, tmp_rhs))
+
+		for (unsigned int j = (unsigned int) walk.size(); j-- > 0; )
 		{
-			_g(u, tmp_rhs);
-			tmp_g = tmp_rhs;
+			Map::Cell* w = walk[j];
+			Map::Cell* succ = *_succ(w);
+			T g = Cost<T>::add(_cost(w, succ), _g(succ));
 
-			_list_remove(u);
+			_g(w, g);
+			_rhs(w, pair<Map::Cell*,T>(succ, g));
+			*_set(w) = SET_CLOSED;
+		}
+	}
 
-			nbrs = u->nbrs();
+	// Only the dropped cells along the kept tree can have an rhs value now
+	Map::Cell* nbrs[N::SIZE];
+	vector<Map::Cell*> reseed;
 
-			for (unsigned int i = 0; i < Map::Cell::NUM_NBRS; i++)
-			{
-				if (nbrs[i] != NULL)
-				{
-					if (nbrs[i] != _goal)
-					{
-						_rhs(nbrs[i], min(_rhs(nbrs[i]), _cost(nbrs[i], u) + tmp_g));
-					}
+	for (unsigned int i = 0; i < kept.size(); i++)
+	{
+		unsigned int n = _map->nbrs<N>(kept[i], nbrs);
 
-					_update(nbrs[i]);
-				}
-			}
-		}
-		else
+		for (unsigned int j = 0; j < n; j++)
 		{
-			g_old = tmp_g;
-			_g(u, Math::INF);
-
-			// Perform action for u
-			if (u != _goal)
+			if (*_set(nbrs[j]) == SET_NONE)
 			{
-				_rhs(u, _min_succ(u).second);
+				*_set(nbrs[j]) = SET_DROPPED;
+				reseed.push_back(nbrs[j]);
 			}
+		}
+	}
 
-			_update(u);
+	// The sets are clear again before any cell is queued
+	for (unsigned int i = 0; i < kept.size(); i++)
+	{
+		*_set(kept[i]) = SET_NONE;
+	}
 
-			nbrs = u->nbrs();
+	for (unsigned int i = 0; i < reseed.size(); i++)
+	{
+		*_set(reseed[i]) = SET_NONE;
+	}
 
-			// Perform action for neighbors
-			for (unsigned int i = 0; i < Map::Cell::NUM_NBRS; i++)
-			{
-				if (nbrs[i] != NULL)
-				{
-					if (Math::equals(_rhs(nbrs[i]), (_cost(nbrs[i], u) + g_old)))
-					{
-						if (nbrs[i] != _goal)
-						{
-							_rhs(nbrs[i], _min_succ(nbrs[i]).second);
-						}
-					}
+	*_set(old) = SET_NONE;
+	*_set(_goal) = SET_NONE;
 
-					_update(nbrs[i]);
-				}
-			}
+	// Keys are computed from scratch, the km of the old start would raise them
+	_km = 0;
+	_last = _start;
+
+	for (unsigned int i = 0; i < reseed.size(); i++)
+	{
+		if (reseed[i] != _goal)
+		{
+			_rhs(reseed[i], _min_succ(reseed[i]));
 		}
+
+		_update(reseed[i]);
 	}
 
-	return true;
+	_update(_goal);
+
+	_bound = Math::INF;
+	_path_clear();
+	_path_stale = false;
+	_path_affected = true;
 }
 
 /**
- * Calculates the cost from one cell to another cell.
- * 
- * @param   Map::Cell*   cell a
- * @param   Map::Cell*   cell b
- * @return  double       cost between a and b
+ * Gets the anytime search set of a cell.
+ *
+ * @param   Map::Cell*       cell
+ * @return  unsigned char*   set
  */
-double Planner::_cost(Map::Cell* a, Map::Cell* b)
+template <typename T, typename N>
+unsigned char* BasicPlanner<T,N>::_set(Map::Cell* u)
 {
-	if (a->cost == Map::Cell::COST_UNWALKABLE || b->cost == Map::Cell::COST_UNWALKABLE)
-		return Map::Cell::COST_UNWALKABLE;
-
-	unsigned int dx = labs(a->x() - b->x());
-	unsigned int dy = labs(a->y() - b->y());
-	double scale = 1.0;
-
-	if ((dx + dy) > 1)
-	{
-		scale = Math::SQRT2;
-	}
+	return (_dense_set != NULL) ? &_dense_set[_id(u)] : &_cell(u)->set;
+}
 
-	return scale * ((a->cost + b->cost) / 2);
+/**
+ * Gets the successor slot of a cell.
+ *
+ * @param   Map::Cell*    cell
+ * @return  Map::Cell**   successor
+ */
+template <typename T, typename N>
+Map::Cell** BasicPlanner<T,N>::_succ(Map::Cell* u)
+{
+	return (_dense_succ != NULL) ? &_dense_succ[_id(u)] : &_cell(u)->succ;
 }
 
 /**
- * Gets/Sets g value for a cell.
- * 
- * @param   Map::Cell*          cell to retrieve/update
- * @param   double [optional]   new g value
- * @return  double              g value 
+ * Lowers epsilon and requeues the open and inconsistent cells under it.
+ *
+ * Every queued key was computed with the old weight, and the open list
+ * can't be walked, so it is emptied and refilled.
+ *
+ * @return  void
  */
-double Planner::_g(Map::Cell* u, double value)
+template <typename T, typename N>
+void BasicPlanner<T,N>::_tighten()
 {
-	_cell(u);
-	pair<double,double>* g_rhs = &_cell_hash[u];
+	_epsilon = max(1.0, _epsilon - _config.epsilon_step);
+
+	DSTARLITE_TRACE_COUNTER("epsilon", _epsilon);
+
+	// The next search starts with an empty CLOSED
+	for (unsigned int i = 0; i < _closed.size(); i++)
+	{
+		*_set(_closed[i]) = SET_NONE;
+	}
+
+	_closed.clear();
+
+	vector<Map::Cell*> cells;
+	cells.swap(_incons);
+	cells.reserve(cells.size() + _open_list->size());
 
-	if (value != DBL_MIN)
+	while ( ! _open_list->empty())
 	{
-		g_rhs->first = value;
+		Map::Cell* u = _open_list->top();
+		_list_remove(u);
+		cells.push_back(u);
 	}
 
-	return g_rhs->first;
+	for (unsigned int i = 0; i < cells.size(); i++)
+	{
+		_update(cells[i]);
+	}
 }
 
 /**
- * Calculates heuristic between two cells (manhattan distance).
+ * Finds the first cell on the successor chain from start that is still
+ * queued and inconsistent.
  *
- * @param   Map::Cell*   cell a
- * @param   Map::Cell*   cell b
- * @return  double       heuristic value
+ * @return  Map::Cell*   cell (NULL if there is none)
  */
-double Planner::_h(Map::Cell* a, Map::Cell* b)
+template <typename T, typename N>
+Map::Cell* BasicPlanner<T,N>::_unsettled()
 {
-	unsigned int min = labs(a->x() - b->x());
-	unsigned int max = labs(a->y() - b->y());
-	
-	if (min > max)
+	Map::Cell* u = _start;
+	unsigned int steps = _map->rows() * _map->cols();
+
+	while (u != NULL && u != _goal && steps-- > 0)
 	{
-		unsigned int tmp = min;
-		min = max;
-		max = tmp;
+		if (*_pos(u) != OL::NONE && ! Cost<T>::equals(_rhs(u), _g(u)))
+			return u;
+
+		if (_g(u) == Cost<T>::inf())
+			return NULL;
+
+		u = *_succ(u);
 	}
-	
-	return ((Math::SQRT2 - 1.0) * min + max);
+
+	return NULL;
 }
 
 /**
- * Calculates key value for cell.
+ * Updates cell.
+ *
+ * A closed cell that became overconsistent waits in INCONS for the next
+ * bound instead of going back on the open list (Anytime D*); one that
+ * became underconsistent is reopened, its g value is no longer a bound.
  *
- * @param   Map::Cell*            cell to calculate for
- * @return  pair<double,double>   key value
+ * @param   Map::Cell*   cell to update
+ * @return  void
  */
-pair<double,double> Planner::_k(Map::Cell* u)
+template <typename T, typename N>
+void BasicPlanner<T,N>::_update(Map::Cell* u)
 {
-	double g = _g(u);
-	double rhs = _rhs(u);
-	double min = (g < rhs) ? g : rhs;
-	return pair<double,double>((min + _h(_start, u) + _km), min);
+	T g = _g(u);
+	T rhs = _rhs(u);
+	bool diff = g != rhs;
+	bool exists = (*_pos(u) != OL::NONE);
+
+	if (_epsilon > 1 && rhs < g && *_set(u) != SET_NONE)
+	{
+		if (exists)
+		{
+			_list_remove(u);
+		}
+
+		if (*_set(u) == SET_CLOSED)
+		{
+			*_set(u) = SET_INCONS;
+			_incons.push_back(u);
+		}
+
+		return;
+	}
+
+	if (diff && exists)
+	{
+		_list_update(u, _k(u));
+	}
+	else if (diff && ! exists)
+	{
+		_list_insert(u, _k(u));
+	}
+	else if ( ! diff && exists)
+	{
+		_list_remove(u);
+	}
 }
 
 /**
- * Inserts cell into open list.
+ * Constructor.
  *
- * @param   Map::Cell*            cell to insert
- * @param   pair<double,double>   key vakue for the cell
- * @return  void
+ * @param  BasicPlanner* [optional]   planner
+ * @param  Map::Cell* [optional]     current cell (NULL is the end)
  */
-void Planner::_list_insert(Map::Cell* u, pair<double,double> k)
+template <typename T, typename N>
+BasicPlanner<T,N>::PathIterator::PathIterator(BasicPlanner* planner, Map::Cell* u)
 {
-	OL::iterator pos = _open_list.insert(OL_PAIR(k, u));
-	_open_hash[u] = pos;
+	_planner = planner;
+	_cell = u;
+	_steps = (planner != NULL) ? planner->_map->rows() * planner->_map->cols() : 0;
 }
 
 /**
- * Removes cell from the open list.
+ * Gets the current cell.
  *
- * @param   Map::Cell*   cell to remove
- * @return  void
+ * @return  Map::Cell*
  */
-void Planner::_list_remove(Map::Cell* u)
+template <typename T, typename N>
+Map::Cell* BasicPlanner<T,N>::PathIterator::operator*()
 {
-	_open_list.erase(_open_hash[u]);
-	_open_hash.erase(_open_hash.find(u));
+	return _cell;
 }
 
 /**
- * Updates cell in the open list.
+ * Moves to the next cell.
  *
- * @param   Map::Cell*
- * @param   pair<double,double>
- * @return  void
+ * @return  PathIterator&
  */
-void Planner::_list_update(Map::Cell* u, pair<double,double> k)
+template <typename T, typename N>
+typename BasicPlanner<T,N>::PathIterator& BasicPlanner<T,N>::PathIterator::operator++()
 {
-	OL::iterator pos1 = _open_hash[u];
-	OL::iterator pos2 = pos1;
-
-	if (pos1 == _open_list.end())
+	if (_cell == _planner->_goal || _planner->_g(_cell) == Cost<T>::inf() || --_steps == 0)
 	{
-		pos2 = _open_list.end();
+		_cell = NULL;
 	}
 	else
 	{
-		pos2++;
+		_cell = *_planner->_succ(_cell);
 	}
 
-	_open_list.erase(pos1);
-	_open_hash[u] = _open_list.insert(pos2, OL_PAIR(k, u));
+	return *this;
 }
 
 /**
- * Finds the minimum successor cell.
+ * Compares iterators.
  *
- * @param   Map::Cell*            root
- * @return  <Map::Cell*,double>   successor
+ * @param   PathIterator
+ * @return  bool
  */
-pair<Map::Cell*,double> Planner::_min_succ(Map::Cell* u)
+template <typename T, typename N>
+bool BasicPlanner<T,N>::PathIterator::operator==(const PathIterator& i) const
 {
-	Map::Cell** nbrs = u->nbrs();
-
-	double tmp_cost, tmp_g;
-	
-	Map::Cell* min_cell = NULL;
-	double min_cost = Math::INF;
-
-	for (unsigned int i = 0; i < Map::Cell::NUM_NBRS; i++)
-	{
-		if (nbrs[i] != NULL)
-		{
-			tmp_cost = _cost(u, nbrs[i]);
-			tmp_g = _g(nbrs[i]);
-
-			if (tmp_cost == Math::INF || tmp_g == Math::INF)
-				continue;
-			
-			tmp_cost += tmp_g;
-
-			if (tmp_cost < min_cost)
-			{
-				min_cell = nbrs[i];
-				min_cost = tmp_cost;
-			}
-		}
-	}
-
-	return pair<Map::Cell*,double>(min_cell, min_cost);
+	return _cell == i._cell;
 }
 
 /**
- * Gets/Sets rhs value for a cell.
- * 
- * @param   Map::Cell*          cell to retrieve/update
- * @param   double [optional]   new rhs value
- * @return  double              rhs value
+ * Compares iterators.
+ *
+ * @param   PathIterator
+ * @return  bool
  */
-double Planner::_rhs(Map::Cell* u, double value)
+template <typename T, typename N>
+bool BasicPlanner<T,N>::PathIterator::operator!=(const PathIterator& i) const
 {
-	if (u == _goal)
-		return 0;
-
-	_cell(u);
-	pair<double,double>* g_rhs = &_cell_hash[u];
+	return _cell != i._cell;
+}
 
-	if (value != DBL_MIN)
-	{
-		g_rhs->second = value;
-	}
-	
-	return g_rhs->second;
+/**
+ * Key compare function.
+ */
+template <typename T, typename N>
+bool BasicPlanner<T,N>::KeyCompare::operator()(const Key& p1, const Key& p2) const
+{
+	return Cost<T>::less(p1, p2);
 }
 
 /**
- * Updates cell.
+ * Gets the first key component in map cost units.
  *
- * @param   Map::Cell*   cell to update
- * @return  void
+ * @param   Key
+ * @return  double
  */
-void Planner::_update(Map::Cell* u)
+template <typename T, typename N>
+double BasicPlanner<T,N>::KeyCompare::primary(const Key& k) const
 {
-	bool diff = _g(u) != _rhs(u);
-	bool exists = (_open_hash.find(u) != _open_hash.end());
-
-	if (diff && exists)
-	{
-		_list_update(u, _k(u));
-	}
-	else if (diff && ! exists)
-	{
-		_list_insert(u, _k(u));
-	}
-	else if ( ! diff && exists)
-	{
-		_list_remove(u);
-	}
+	return Cost<T>::primary(k);
 }
 
 /**
- * Key compare function.
+ * Cell change compare function.
  */
-bool Planner::KeyCompare::operator()(const pair<double,double>& p1, const pair<double,double>& p2) const
+template <typename T, typename N>
+bool BasicPlanner<T,N>::CellLess::operator()(const pair<Map::Cell*,double>& p1, const pair<Map::Cell*,double>& p2) const
 {
-	if (Math::less(p1.first, p2.first))				return true;
-	else if (Math::greater(p1.first, p2.first))		return false;
-	else if (Math::less(p1.second,  p2.second))		return true;
-	else if (Math::greater(p1.second, p2.second))	return false;
-													return false;
+	return p1.first < p2.first;
 }
+
+template class BasicPlanner<double, Neighborhood4>;
+template class BasicPlanner<double, Neighborhood8>;
+template class BasicPlanner<double, Neighborhood16>;
+template class BasicPlanner<float, Neighborhood4>;
+template class BasicPlanner<float, Neighborhood8>;
+template class BasicPlanner<float, Neighborhood16>;
+template class BasicPlanner<Fixed, Neighborhood4>;
+template class BasicPlanner<Fixed, Neighborhood8>;
+template class BasicPlanner<Fixed, Neighborhood16>;
@@ -14,31 +14,295 @@
 #ifndef DSTARLITE_PLANNER_H
 #define DSTARLITE_PLANNER_H
 
+#include <algorithm>
 #include <list>
-#include <map>
+#include <vector>
 #ifdef WIN32
 	#include <unordered_map>
 #else
 	#include <tr1/unordered_map>
 #endif
+#include "buckets.h"
+#include "cost.h"
+#include "heap.h"
 #include "map.h"
 #include "math.h"
 
+/**
+ * Search statistics are only counted when DSTARLITE_STATS is defined,
+ * otherwise every counting statement compiles to nothing.
+ */
+#ifdef DSTARLITE_STATS
+	#define DSTARLITE_STAT(statement) statement
+#else
+	#define DSTARLITE_STAT(statement)
+#endif
+
 using namespace std;
 using namespace DStarLite;
 
 namespace DStarLite
 {
-	class Planner
+	/**
+	 * Planner templated on its cost type (see Cost) and grid connectivity
+	 * (see Neighborhood8).
+	 */
+	template <typename T, typename N = Neighborhood8>
+	class BasicPlanner
 	{
 		public:
 
+			/**
+			 * @var  typedef  key type of the cost
+			 */
+			typedef typename Cost<T>::Key Key;
+
+			/**
+			 * Config class.
+			 */
+			class Config
+			{
+				public:
+
+					/**
+					 * Open list implementations.
+					 */
+					enum Queue
+					{
+						/**
+						 * Indexed 4-ary heap (default).
+						 */
+						QUEUE_HEAP,
+
+						/**
+						 * Bucket queue over keys quantized by bucket_width.
+						 */
+						QUEUE_BUCKETS
+					};
+
+					/**
+					 * Cell state storage modes.
+					 */
+					enum Storage
+					{
+						/**
+						 * Contiguous arrays indexed by row * cols + col (default).
+						 */
+						STORAGE_DENSE,
+
+						/**
+						 * Hash of the cells the search has touched.
+						 */
+						STORAGE_HASH,
+
+						/**
+						 * One block per map tile, allocated when the search first
+						 * touches the tile (the default for tiled maps).
+						 */
+						STORAGE_TILED
+					};
+
+					/**
+					 * @var  double  bucket width in key units (QUEUE_BUCKETS only)
+					 */
+					double bucket_width;
+
+					/**
+					 * @var  unsigned long  expansions per replan() before the search is suspended (0 for no limit)
+					 */
+					unsigned long budget_expansions;
+
+					/**
+					 * @var  double  seconds per replan() before the search is suspended (0 for no limit)
+					 */
+					double budget_time;
+
+					/**
+					 * @var  double  heuristic weight of the first search (1 is plain D* Lite)
+					 */
+					double epsilon;
+
+					/**
+					 * @var  double  how much the weight is lowered by each replan() after a finished search
+					 */
+					double epsilon_step;
+
+					/**
+					 * @var  Queue  open list implementation
+					 */
+					Queue queue;
+
+					/**
+					 * @var  Storage  cell state storage
+					 */
+					Storage storage;
+
+					/**
+					 * Constructor.
+					 */
+					Config();
+			};
+
+			/**
+			 * Path iterator.
+			 *
+			 * Walks the cached successors from the start without building a list.
+			 */
+			class PathIterator
+			{
+				public:
+
+					/**
+					 * Constructor.
+					 *
+					 * @param  BasicPlanner* [optional]   planner
+					 * @param  Map::Cell* [optional]     current cell (NULL is the end)
+					 */
+					PathIterator(BasicPlanner* planner = NULL, Map::Cell* u = NULL);
+
+					/**
+					 * Gets the current cell.
+					 *
+					 * @return  Map::Cell*
+					 */
+					Map::Cell* operator*();
+
+					/**
+					 * Moves to the next cell.
+					 *
+					 * @return  PathIterator&
+					 */
+					PathIterator& operator++();
+
+					/**
+					 * Compares iterators.
+					 *
+					 * @param   PathIterator
+					 * @return  bool
+					 */
+					bool operator==(const PathIterator& i) const;
+
+					/**
+					 * Compares iterators.
+					 *
+					 * @param   PathIterator
+					 * @return  bool
+					 */
+					bool operator!=(const PathIterator& i) const;
+
+				protected:
+
+					/**
+					 * @var  Map::Cell*  current cell
+					 */
+					Map::Cell* _cell;
+
+					/**
+					 * @var  BasicPlanner*  planner
+					 */
+					BasicPlanner* _planner;
+
+					/**
+					 * @var  unsigned int  steps left before giving up (guards against cycles)
+					 */
+					unsigned int _steps;
+			};
+
 			/**
 			 * Key compare struct.
 			 */
-			struct KeyCompare : public binary_function<pair<double,double>, pair<double,double>, bool>
+			struct KeyCompare : public binary_function<Key, Key, bool>
+			{
+				bool operator()(const Key& p1, const Key& p2) const;
+
+				/**
+				 * Gets the first key component in map cost units (used by Buckets).
+				 */
+				double primary(const Key& k) const;
+			};
+
+			/**
+			 * Search statistics (all zero unless built with DSTARLITE_STATS).
+			 */
+			class Stats
 			{
-				bool operator()(const pair<double,double>& p1, const pair<double,double>& p2) const;
+				public:
+
+					/**
+					 * @var  unsigned long  cells materialized (hash entries, or tile blocks in cells)
+					 */
+					unsigned long cells;
+
+					/**
+					 * @var  double  seconds spent in _compute()
+					 */
+					double compute_time;
+
+					/**
+					 * @var  unsigned long  overconsistent expansions (g lowered to rhs)
+					 */
+					unsigned long expansions_over;
+
+					/**
+					 * @var  unsigned long  underconsistent expansions (g raised to infinity)
+					 */
+					unsigned long expansions_under;
+
+					/**
+					 * @var  unsigned long  open list inserts
+					 */
+					unsigned long inserts;
+
+					/**
+					 * @var  unsigned long  _min_succ() calls
+					 */
+					unsigned long min_succ;
+
+					/**
+					 * @var  unsigned long  largest open list size
+					 */
+					unsigned long open_peak;
+
+					/**
+					 * @var  unsigned long  cells on the last path built
+					 */
+					unsigned long path_length;
+
+					/**
+					 * @var  double  seconds spent building paths
+					 */
+					double path_time;
+
+					/**
+					 * @var  unsigned long  open list removes
+					 */
+					unsigned long removes;
+
+					/**
+					 * @var  unsigned long  open list updates
+					 */
+					unsigned long updates;
+
+					/**
+					 * Constructor.
+					 */
+					Stats();
+
+					/**
+					 * Adds a later record (the peak is the larger one, the path
+					 * length the later one).
+					 *
+					 * @param   Stats   record
+					 * @return  void
+					 */
+					void add(const Stats& stats);
+
+					/**
+					 * Gets all expansions.
+					 *
+					 * @return  unsigned long
+					 */
+					unsigned long expansions() const;
 			};
 
 			/*
@@ -52,36 +316,149 @@ namespace DStarLite
 			 * @param  Map*         map
 			 * @param  Map::Cell*   start cell
 			 * @param  Map::Cell*   goal cell
+			 * @param  Config       config options
 			 */
-			Planner(Map* map,  Map::Cell* start, Map::Cell* goal);
+			BasicPlanner(Map* map,  Map::Cell* start, Map::Cell* goal, Config config = Config());
 
 			/**
 			 * Deconstructor.
 			 */
-			~Planner();
+			~BasicPlanner();
+
+			/**
+			 * Determines if a replan could change the path.
+			 *
+			 * False when the start is on the last path, no update since touched
+			 * a cell on it (or its moves), and the search would not expand
+			 * anything; replan() then only drops the cells behind the start.
+			 *
+			 * @return  bool
+			 */
+			bool affected();
+
+			/**
+			 * Gets the suboptimality bound of the last finished search.
+			 *
+			 * With an epsilon above 1 (see Config) the first search expands
+			 * fewer cells and returns a path at most epsilon times the optimal
+			 * cost. Each replan() after it lowers the weight by epsilon_step and
+			 * reuses the search to improve the path, until the bound is 1.
+			 *
+			 * @return  double   bound (infinite before the first search)
+			 */
+			double bound();
+
+			/**
+			 * Gets the cost of a cell as this planner knows it.
+			 *
+			 * The map itself is never written, updates only change the planner's
+			 * own copy, so many planners can share (and read) one map.
+			 *
+			 * @param   Map::Cell*   cell
+			 * @return  double       cost
+			 */
+			double cost(Map::Cell* u);
+
+			/**
+			 * Gets the number of cells expanded by all replans (refreshing a stale
+			 * key doesn't count).
+			 *
+			 * @return  unsigned long
+			 */
+			unsigned long expansions();
 
 			/**
-			 * Returns the generated path.
+			 * Returns the generated path (built on first use after a replan).
 			 *
 			 * @return  list<Map::Cell*>   path
 			 */
-			list<Map::Cell*> path();
+			const list<Map::Cell*>& path();
+
+			/**
+			 * Gets an iterator at the start of the path.
+			 *
+			 * @return  PathIterator
+			 */
+			PathIterator path_begin();
+
+			/**
+			 * Gets the iterator past the end of the path.
+			 *
+			 * @return  PathIterator
+			 */
+			PathIterator path_end();
 
 			/**
 			 * Gets/Sets a new goal.
 			 *
+			 * The search tree is kept where it still leads to the new goal, and
+			 * only the rest is searched again by the next replan() (Moving
+			 * Target D* Lite).
+			 *
 			 * @param   Map::Cell* [optional]   goal
 			 * @return  Map::Cell*              new goal
 			 */
 			Map::Cell* goal(Map::Cell* u = NULL);
 
 			/**
-			 * Replans the path.
+			 * Restores a search from a snapshot (see save()).
+			 *
+			 * Values, queue, start, goal and km are taken over, so the next
+			 * replan() carries on as the saved planner would have, without the
+			 * search from scratch. The map must hold the same costs as when the
+			 * snapshot was saved; the planner's own updates are in the snapshot.
+			 *
+			 * @param   char*   file name
+			 * @return  bool    successful (false if the file is missing, short,
+			 *                  another version, byte order, cost type or
+			 *                  neighborhood, or was saved on another map; the
+			 *                  planner is unchanged then)
+			 */
+			bool load(const char* file);
+
+			/**
+			 * Gets the next cell on the path.
+			 *
+			 * While the search is suspended() there is no path yet, the next cell
+			 * is a best guess: the neighbor with the lowest move cost plus g
+			 * value, or plus heuristic to the goal if no neighbor has a g value.
+			 *
+			 * @return  Map::Cell*   next cell (NULL at the goal or without a path)
+			 */
+			Map::Cell* next_step();
+
+			/**
+			 * Replans the path (almost free when nothing affected() it).
+			 *
+			 * With a budget (see Config), the search stops when it runs out and
+			 * replan() returns false with suspended() set. The next replan()
+			 * carries on where it stopped, updates and moves in between are fine.
 			 *
 			 * @return  bool   solution found
 			 */
 			bool replan();
 
+			/**
+			 * Saves the search as a binary snapshot.
+			 *
+			 * A fixed 128 byte header (see Snapshot) followed by arrays in
+			 * native byte order, one entry per cell with a g or rhs value:
+			 *
+			 *   uint32[cells]   cell (row * columns + column)
+			 *   uint32[cells]   successor cell (0xFFFFFFFF for none)
+			 *   T[cells]        g values
+			 *   T[cells]        rhs values
+			 *   uint8[cells]    anytime set, 0x80 when on the open list
+			 *   uint32[costs]   cell with a cost that differs from the map
+			 *   double[costs]   its cost as the planner knows it
+			 *
+			 * Open list keys are not stored, load() computes them again.
+			 *
+			 * @param   char*   file name
+			 * @return  bool    successful
+			 */
+			bool save(const char* file);
+
 			/**
 			 * Gets/Sets start.
 			 *
@@ -91,7 +468,36 @@ namespace DStarLite
 			Map::Cell* start(Map::Cell* u = NULL);
 
 			/**
-			 * Update map.
+			 * Gets the statistics since the last replan() started (the replan, the
+			 * path built after it, and any updates since).
+			 *
+			 * @return  Stats
+			 */
+			const Stats& stats();
+
+			/**
+			 * Resets the statistics.
+			 *
+			 * @return  void
+			 */
+			void stats_reset();
+
+			/**
+			 * Gets the statistics since construction or stats_reset().
+			 *
+			 * @return  Stats
+			 */
+			Stats stats_total();
+
+			/**
+			 * Determines if the last replan() ran out of budget before it finished.
+			 *
+			 * @return  bool
+			 */
+			bool suspended();
+
+			/**
+			 * Update map (see cost()).
 			 *
 			 * @param   Map::Cell*   cell to update
 			 * @param   double       new cost of the cell
@@ -99,18 +505,263 @@ namespace DStarLite
 			 */
 			void update(Map::Cell* u, double cost);
 
+			/**
+			 * Update map with many cells at once.
+			 *
+			 * Repeated changes to the same cell are coalesced (the last one wins),
+			 * km is bumped once and every affected rhs value is re-evaluated once.
+			 *
+			 * @param   vector<pair<Map::Cell*,double> >   cells to update and their new costs
+			 * @return  void
+			 */
+			void update_batch(const vector<pair<Map::Cell*,double> >& changes);
+
 		protected:			
 
+			/**
+			 * Cell sets of the anytime search (see bound()) and of goal moves.
+			 */
+			enum Set
+			{
+				/**
+				 * Not expanded by the current search.
+				 */
+				SET_NONE,
+
+				/**
+				 * Expanded overconsistent by the current search (CLOSED).
+				 */
+				SET_CLOSED,
+
+				/**
+				 * Closed and inconsistent again, waits for the next bound (INCONS).
+				 */
+				SET_INCONS,
+
+				/**
+				 * Leads to the new goal, kept by a goal move.
+				 */
+				SET_KEPT,
+
+				/**
+				 * Does not lead to the new goal, reset by a goal move.
+				 */
+				SET_DROPPED
+			};
+
+			/**
+			 * Snapshot file header (see save()).
+			 *
+			 *   0   char[4]    magic "DSLP"
+			 *   4   uint32     version
+			 *   8   uint32     byte order mark (0x01020304 as written)
+			 *   12  uint32     cost size (sizeof(T))
+			 *   16  uint32     neighborhood size (N::SIZE)
+			 *   20  uint32     map rows
+			 *   24  uint32     map columns
+			 *   28  uint32     rows searched (tiled maps can grow)
+			 *   32  uint32     columns searched
+			 *   36  uint32     start cell
+			 *   40  uint32     goal cell
+			 *   44  uint32     last start cell
+			 *   48  uint32     cells stored
+			 *   52  uint32     costs stored
+			 *   56  uint32     suspended
+			 *   60  uint32     reserved (zero)
+			 *   64  uint64     map checksum (see Map::checksum())
+			 *   72  uint8[8]   infinite cost, as T stores it (tells the cost types apart)
+			 *   80  double     km
+			 *   88  double     epsilon
+			 *   96  double     bound
+			 *   104 ...        reserved (zero)
+			 */
+			struct Snapshot
+			{
+				char magic[4];
+				uint32_t version;
+				uint32_t order;
+				uint32_t cost;
+				uint32_t neighborhood;
+				uint32_t rows;
+				uint32_t cols;
+				uint32_t searched_rows;
+				uint32_t searched_cols;
+				uint32_t start;
+				uint32_t goal;
+				uint32_t last;
+				uint32_t cells;
+				uint32_t costs;
+				uint32_t suspended;
+				uint32_t reserved;
+				uint64_t checksum;
+				unsigned char inf[8];
+				double km;
+				double epsilon;
+				double bound;
+				uint32_t reserved_end[6];
+			};
+
+			/**
+			 * @var  static const uint32_t  snapshot byte order mark
+			 */
+			static const uint32_t SNAPSHOT_ORDER = 0x01020304;
+
+			/**
+			 * @var  static const uint32_t  snapshot cell without a successor
+			 */
+			static const uint32_t SNAPSHOT_NONE = 0xFFFFFFFF;
+
+			/**
+			 * @var  static const unsigned char  snapshot flag of a cell on the open list
+			 */
+			static const unsigned char SNAPSHOT_OPEN = 0x80;
+
+			/**
+			 * @var  static const uint32_t  current snapshot version
+			 */
+			static const uint32_t SNAPSHOT_VERSION = 1;
+
+			/**
+			 * Cell change compare struct (orders by cell only).
+			 */
+			struct CellLess
+			{
+				bool operator()(const pair<Map::Cell*,double>& p1, const pair<Map::Cell*,double>& p2) const;
+			};
+
+			/**
+			 * Cell state.
+			 */
+			struct State
+			{
+				/**
+				 * @var  T  g value
+				 */
+				T g;
+
+				/**
+				 * @var  T  rhs value
+				 */
+				T rhs;
+
+				/**
+				 * @var  unsigned int  position in the open list
+				 */
+				unsigned int pos;
+
+				/**
+				 * @var  unsigned char  anytime search set
+				 */
+				unsigned char set;
+
+				/**
+				 * @var  bool  on the current path
+				 */
+				bool path;
+
+				/**
+				 * @var  Map::Cell*  successor that defines rhs
+				 */
+				Map::Cell* succ;
+			};
+
 			/**
 			 * @var  unordered_map  cell hash (keeps track of all the cells)
 			 */
-			typedef tr1::unordered_map<Map::Cell*, pair<double,double>, Map::Cell::Hash> CH;
+			typedef tr1::unordered_map<Map::Cell*, State, Map::Cell::Hash> CH;
 			CH _cell_hash;
 
 			/**
-			 * @var  double  accumulated heuristic value
+			 * @var  unordered_map  cell costs that differ from the map (hash storage)
+			 */
+			typedef tr1::unordered_map<Map::Cell*, double, Map::Cell::Hash> CC;
+			CC _cost_hash;
+
+			/**
+			 * @var  Config  planner config options
+			 */
+			Config _config;
+
+			/**
+			 * @var  double  suboptimality bound of the last finished search
+			 */
+			double _bound;
+
+			/**
+			 * @var  vector<Map::Cell*>  cells expanded overconsistent by the current search
+			 */
+			vector<Map::Cell*> _closed;
+
+			/**
+			 * @var  CostLayer*  dense cell costs, a copy of the map's (NULL until the first update)
+			 */
+			CostLayer* _dense_cost;
+
+			/**
+			 * @var  T*  dense g values
+			 */
+			T* _dense_g;
+
+			/**
+			 * @var  bool*  dense path flags
+			 */
+			bool* _dense_path;
+
+			/**
+			 * @var  unsigned int*  dense open list positions (NONE when not in the open list)
+			 */
+			unsigned int* _dense_pos;
+
+			/**
+			 * @var  T*  dense rhs values
+			 */
+			T* _dense_rhs;
+
+			/**
+			 * @var  unsigned char*  dense cell sets (only with an epsilon above 1, or after a goal move)
+			 */
+			unsigned char* _dense_set;
+
+			/**
+			 * @var  Map::Cell**  dense successors
+			 */
+			Map::Cell** _dense_succ;
+
+			/**
+			 * @var  unsigned int  map rows and columns at the last replan (tiled maps can grow)
+			 */
+			unsigned int _rows;
+			unsigned int _cols;
+
+			/**
+			 * @var  vector<State*>  cell states by map tile id (NULL until touched)
+			 */
+			vector<State*> _tiles;
+
+			/**
+			 * @var  vector<Map::Cell*>  first map cell of every tile in _tiles
+			 */
+			vector<Map::Cell*> _tile_cells;
+
+			/**
+			 * @var  double  current heuristic weight
+			 */
+			double _epsilon;
+
+			/**
+			 * @var  unsigned long  cells expanded
+			 */
+			unsigned long _expansions;
+
+			/**
+			 * @var  vector<Map::Cell*>  closed cells that became inconsistent (INCONS)
 			 */
-			double _km;
+			vector<Map::Cell*> _incons;
+
+			/**
+			 * @var  T  accumulated heuristic value
+			 */
+			T _km;
 
 			/**
 			 * @var  Map*  map
@@ -123,17 +774,25 @@ namespace DStarLite
 			list<Map::Cell*> _path;
 
 			/**
-			 * @var  multimap  open list
+			 * @var  bool  an update touched a cell on the path since it was built
+			 */
+			bool _path_affected;
+
+			/**
+			 * @var  bool  path needs to be rebuilt
 			 */
-			typedef pair<pair<double,double>, Map::Cell*> OL_PAIR;
-			typedef multimap<pair<double,double>, Map::Cell*, KeyCompare> OL;
-			OL _open_list;
+			bool _path_stale;
 
 			/**
-			 * @var  unordered_map  open hash (stores position in multimap)
+			 * @var  bool  the last search ran out of budget
 			 */
-			typedef tr1::unordered_map<Map::Cell*, OL::iterator, Map::Cell::Hash> OH;
-			OH _open_hash;
+			bool _suspended;
+
+			/**
+			 * @var  OpenList*  open list (cell positions are stored in the cell state)
+			 */
+			typedef OpenList<Key, KeyCompare> OL;
+			OL* _open_list;
 
 			/**
 			 * @var  Map::Cell*  start, goal, and last start tile
@@ -142,64 +801,131 @@ namespace DStarLite
 			Map::Cell* _goal;
 			Map::Cell* _last;
 
+			/**
+			 * @var  Stats  statistics since the last replan() started
+			 */
+			Stats _stats;
+
+			/**
+			 * @var  Stats  statistics before the last replan() started
+			 */
+			Stats _stats_total;
+
 			/**
 			 * Generates a cell.
 			 *
 			 * @param   Map::Cell*
+			 * @return  State*
+			 */
+			State* _cell(Map::Cell* u);
+
+			/**
+			 * Gets the cost of a cell.
+			 *
+			 * @param   Map::Cell*   cell
+			 * @return  double       cost
+			 */
+			double _cell_cost(Map::Cell* u);
+
+			/**
+			 * Lists every cell with a g or rhs value.
+			 *
+			 * @param   vector<Map::Cell*>&   cells
+			 * @return  void
+			 */
+			void _cells(vector<Map::Cell*>& cells);
+
+			/**
+			 * Sets the cost of a cell (the map is left alone).
+			 *
+			 * @param   Map::Cell*   cell
+			 * @param   double       new cost
 			 * @return  void
 			 */
-			void _cell(Map::Cell* u);
+			void _cell_cost(Map::Cell* u, double cost);
 
 			/**
 			 * Computes shortest path.
 			 *
-			 * @return  bool   successful
+			 * @param   Map::Cell*   cell to settle (the start, or a queued cell of its path)
+			 * @return  bool         successful
 			 */
-			bool _compute();
+			bool _compute(Map::Cell* target);
 
 			/**
 			 * Calculates the cost from one cell to another cell.
 			 * 
 			 * @param   Map::Cell*   cell a
 			 * @param   Map::Cell*   cell b
-			 * @return  double       cost between a and b
+			 * @return  T            cost between a and b
+			 */
+			T _cost(Map::Cell* a, Map::Cell* b);
+
+			/**
+			 * Gets g value for a cell.
+			 * 
+			 * @param   Map::Cell*   cell to retrieve
+			 * @return  T            g value 
 			 */
-			double _cost(Map::Cell* a, Map::Cell* b);
+			T _g(Map::Cell* u);
 
 			/**
-			 * Gets/Sets g value for a cell.
+			 * Sets g value for a cell.
 			 * 
-			 * @param   Map::Cell*          cell to retrieve/update
-			 * @param   double [optional]   new g value
-			 * @return  double              g value 
+			 * @param   Map::Cell*   cell to update
+			 * @param   T            new g value
+			 * @return  T            g value 
+			 */
+			T _g(Map::Cell* u, T value);
+
+			/**
+			 * Gets the dense index of a cell.
+			 *
+			 * @param   Map::Cell*     cell
+			 * @return  unsigned int   row * cols + col
+			 */
+			unsigned int _id(Map::Cell* u);
+
+			/**
+			 * Brings the cells along the old edges up to date after the map grew.
+			 *
+			 * @return  void
 			 */
-			double _g(Map::Cell* u, double value = DBL_MIN);
+			void _grown();
 
 			/**
-			 * Calculates heuristic between two cells (manhattan distance).
+			 * Calculates heuristic between two cells (distance under the neighborhood).
 			 *
 			 * @param   Map::Cell*   cell a
 			 * @param   Map::Cell*   cell b
-			 * @return  double       heuristic value
+			 * @return  T            heuristic value
+			 */
+			T _h(Map::Cell* a, Map::Cell* b);
+
+			/**
+			 * Weighs a heuristic value by the current epsilon.
+			 *
+			 * @param   T   heuristic value
+			 * @return  T   weighted value
 			 */
-			double _h(Map::Cell* a, Map::Cell* b);
+			T _inflate(T h);
 
 			/**
 			 * Calculates key value for cell.
 			 *
-			 * @param   Map::Cell*            cell to calculate for
-			 * @return  pair<double,double>   key value
+			 * @param   Map::Cell*   cell to calculate for
+			 * @return  Key          key value
 			 */
-			pair<double,double> _k(Map::Cell* u);
+			Key _k(Map::Cell* u);
 
 			/**
 			 * Inserts cell into open list.
 			 *
-			 * @param   Map::Cell*            cell to insert
-			 * @param   pair<double,double>   key vakue for the cell
+			 * @param   Map::Cell*   cell to insert
+			 * @param   Key          key vakue for the cell
 			 * @return  void
 			 */
-			void _list_insert(Map::Cell* u, pair<double,double> k);
+			void _list_insert(Map::Cell* u, Key k);
 
 			/**
 			 * Removes cell from the open list.
@@ -213,27 +939,114 @@ namespace DStarLite
 			 * Updates cell in the open list.
 			 *
 			 * @param   Map::Cell*
-			 * @param   pair<double,double>
+			 * @param   Key
 			 * @return  void
 			 */
-			void _list_update(Map::Cell* u, pair<double,double> k);
+			void _list_update(Map::Cell* u, Key k);
 
 			/**
 			 * Finds the minimum successor cell.
 			 *
-			 * @param   Map::Cell*                root
-			 * @return  pair<Map::Cell*,double>   successor
+			 * @param   Map::Cell*           root
+			 * @return  pair<Map::Cell*,T>   successor
+			 */
+			pair<Map::Cell*,T> _min_succ(Map::Cell* u);
+
+			/**
+			 * Clears the path and its flags.
+			 *
+			 * @return  void
+			 */
+			void _path_clear();
+
+			/**
+			 * Gets the path flag of a cell.
+			 *
+			 * @param   Map::Cell*   cell
+			 * @return  bool*        on the current path
+			 */
+			bool* _path_flag(Map::Cell* u);
+
+			/**
+			 * Marks the path affected if a cell about to change is on it.
+			 *
+			 * @param   Map::Cell*   cell
+			 * @return  void
+			 */
+			void _path_touch(Map::Cell* u);
+
+			/**
+			 * Gets the open list position of a cell.
+			 *
+			 * @param   Map::Cell*      cell
+			 * @return  unsigned int*   position
+			 */
+			unsigned int* _pos(Map::Cell* u);
+
+			/**
+			 * Gets rhs value for a cell.
+			 * 
+			 * @param   Map::Cell*   cell to retrieve
+			 * @return  T            rhs value
+			 */
+			T _rhs(Map::Cell* u);
+
+			/**
+			 * Sets rhs value for a cell.
+			 * 
+			 * @param   Map::Cell*   cell to update
+			 * @param   T            new rhs value
+			 * @return  T            rhs value
 			 */
-			pair<Map::Cell*,double> _min_succ(Map::Cell* u);
+			T _rhs(Map::Cell* u, T value);
 
 			/**
-			 * Gets/Sets rhs value for a cell.
+			 * Sets rhs value and successor for a cell.
 			 * 
-			 * @param   Map::Cell*          cell to retrieve/update
-			 * @param   double [optional]   new rhs value
-			 * @return  double              rhs value
+			 * @param   Map::Cell*           cell to update
+			 * @param   pair<Map::Cell*,T>   successor and new rhs value
+			 * @return  T                    rhs value
+			 */
+			T _rhs(Map::Cell* u, pair<Map::Cell*,T> succ);
+
+			/**
+			 * Moves the goal, keeping the part of the search tree that still holds.
+			 *
+			 * @param   Map::Cell*   new goal
+			 * @return  void
+			 */
+			void _retarget(Map::Cell* u);
+
+			/**
+			 * Gets the anytime search set of a cell.
+			 *
+			 * @param   Map::Cell*       cell
+			 * @return  unsigned char*   set
+			 */
+			unsigned char* _set(Map::Cell* u);
+
+			/**
+			 * Gets the successor slot of a cell.
+			 *
+			 * @param   Map::Cell*    cell
+			 * @return  Map::Cell**   successor
+			 */
+			Map::Cell** _succ(Map::Cell* u);
+
+			/**
+			 * Lowers epsilon and requeues the open and inconsistent cells under it.
+			 *
+			 * @return  void
+			 */
+			void _tighten();
+
+			/**
+			 * Finds the first cell on the successor chain from start that is
+			 * still queued and inconsistent.
+			 *
+			 * @return  Map::Cell*   cell (NULL if there is none)
 			 */
-			double _rhs(Map::Cell* u, double value = DBL_MIN);
+			Map::Cell* _unsettled();
 
 			/**
 			 * Updates cell.
@@ -243,6 +1056,31 @@ namespace DStarLite
 			 */
 			void _update(Map::Cell* u);
 	};
+
+	/**
+	 * @var  typedef  reference planner (double costs)
+	 */
+	typedef BasicPlanner<double> Planner;
+
+	/**
+	 * @var  typedef  reference planner without diagonal moves
+	 */
+	typedef BasicPlanner<double, Neighborhood4> Planner4;
+
+	/**
+	 * @var  typedef  reference planner with knight moves
+	 */
+	typedef BasicPlanner<double, Neighborhood16> Planner16;
+
+	/**
+	 * @var  typedef  float planner
+	 */
+	typedef BasicPlanner<float> FloatPlanner;
+
+	/**
+	 * @var  typedef  fixed point planner
+	 */
+	typedef BasicPlanner<Fixed> FixedPlanner;
 };
 
 
@@ -0,0 +1,626 @@
+/**
+ * Simulation.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#include "bitmap.h"
+#include "diff.h"
+#include "hierarchical_planner.h"
+#include "math.h"
+#include "simulation.h"
+#include "timer.h"
+#include "trace.h"
+
+using namespace DStarLite;
+
+/**
+ * Constructor.
+ */
+template <typename P>
+BasicSimulation<P>::Config::Config()
+{
+	// Bitmap costs are whole numbers, one byte each is exact
+	format = CostLayer::FORMAT_UINT8;
+	goal = pair<unsigned int, unsigned int>(0, 0);
+	scan_radius = 0;
+	sensor = SENSOR_INCREMENTAL;
+	start = pair<unsigned int, unsigned int>(0, 0);
+	tile_size = 0;
+}
+
+/**
+ * Constructor.
+ */
+template <typename P>
+BasicSimulation<P>::Stats::Stats()
+{
+	cost = 0;
+	initial = 0;
+	interim = 0;
+	latency_max = 0;
+	latency_total = 0;
+	replans = 0;
+	steps = 0;
+	wall = 0;
+}
+
+/**
+ * Constructor.
+ *
+ * Both maps are gray values, row by row from the top (see Bitmap).
+ * The robot map is updated as the robot scans.
+ *
+ * @param  unsigned char*   real map
+ * @param  unsigned char*   robot map
+ * @param  unsigned int     rows
+ * @param  unsigned int     columns
+ * @param  Config           config options
+ */
+template <typename P>
+BasicSimulation<P>::BasicSimulation(unsigned char* real, unsigned char* robot, unsigned int rows, unsigned int cols, Config config)
+{
+	_config = config;
+	_init = false;
+	_real = real;
+	_robot = robot;
+	_scanned = false;
+	_scan_x = 0;
+	_scan_y = 0;
+	_status = STATUS_RUNNING;
+
+	Map::Config map_config;
+	map_config.format = config.format;
+	map_config.tile_size = config.tile_size;
+
+	_map = new Map(rows, cols, map_config);
+
+	// Build map
+	for (unsigned int i = 0; i < rows; i++)
+	{
+		for (unsigned int j = 0; j < cols; j++)
+		{
+			_map->cost((*_map)(i, j), Bitmap::cost(_robot[i * cols + j]));
+		}
+	}
+
+	// Make planner
+	_planner = new Planner(_map, (*_map)(config.start.first, config.start.second), (*_map)(config.goal.first, config.goal.second), config.planner);
+
+	// Push start position
+	_path_traversed.push_back(_planner->start());
+}
+
+/**
+ * Deconstructor.
+ */
+template <typename P>
+BasicSimulation<P>::~BasicSimulation()
+{
+	delete _planner;
+	delete _map;
+}
+
+/**
+ * Gets the current position.
+ *
+ * @return  Map::Cell*
+ */
+template <typename P>
+Map::Cell* BasicSimulation<P>::current()
+{
+	return _planner->start();
+}
+
+/**
+ * Gets the goal.
+ *
+ * @return  Map::Cell*
+ */
+template <typename P>
+Map::Cell* BasicSimulation<P>::goal()
+{
+	return _planner->goal();
+}
+
+/**
+ * Plans the first path (step() does it if needed).
+ *
+ * @return  Status
+ */
+template <typename P>
+typename BasicSimulation<P>::Status BasicSimulation<P>::init()
+{
+	if (_init)
+		return _status;
+
+	_init = true;
+
+	Timer timer;
+
+	if ( ! _replan() && ! _planner->suspended())
+	{
+		_status = STATUS_NO_PATH;
+	}
+
+	_stats.initial = timer.elapsed();
+	_stats.wall += _stats.initial;
+
+	return _status;
+}
+
+/**
+ * Gets the robot map.
+ *
+ * @return  Map*
+ */
+template <typename P>
+Map* BasicSimulation<P>::map()
+{
+	return _map;
+}
+
+/**
+ * Gets the cells left to drive on the planned path.
+ *
+ * @return  list<Map::Cell*>
+ */
+template <typename P>
+const list<Map::Cell*>& BasicSimulation<P>::path_planned()
+{
+	return _path_planned;
+}
+
+/**
+ * Gets the cells driven so far, starting with the start.
+ *
+ * @return  list<Map::Cell*>
+ */
+template <typename P>
+const list<Map::Cell*>& BasicSimulation<P>::path_traversed()
+{
+	return _path_traversed;
+}
+
+/**
+ * Gets the planner.
+ *
+ * @return  Planner*
+ */
+template <typename P>
+typename BasicSimulation<P>::Planner* BasicSimulation<P>::planner()
+{
+	return _planner;
+}
+
+/**
+ * Runs until the robot reaches the goal or gets stuck, as fast as possible.
+ *
+ * @return  Status
+ */
+template <typename P>
+typename BasicSimulation<P>::Status BasicSimulation<P>::run()
+{
+	while (step() == STATUS_RUNNING);
+
+	return _status;
+}
+
+/**
+ * Scans the full circle on the next step (after the real map changed
+ * where the robot already looked).
+ *
+ * @return  void
+ */
+template <typename P>
+void BasicSimulation<P>::rescan()
+{
+	_scanned = false;
+}
+
+/**
+ * Gets the scanner radius.
+ *
+ * @return  unsigned int
+ */
+template <typename P>
+unsigned int BasicSimulation<P>::scan_radius()
+{
+	return _config.scan_radius;
+}
+
+/**
+ * Sets the scanner radius (the next step scans the full circle).
+ *
+ * @param   unsigned int   radius
+ * @return  void
+ */
+template <typename P>
+void BasicSimulation<P>::scan_radius(unsigned int radius)
+{
+	_config.scan_radius = radius;
+	_scanned = false;
+}
+
+/**
+ * Gets the stats so far.
+ *
+ * @return  Stats
+ */
+template <typename P>
+const typename BasicSimulation<P>::Stats& BasicSimulation<P>::stats()
+{
+	return _stats;
+}
+
+/**
+ * Gets the current state.
+ *
+ * @return  Status
+ */
+template <typename P>
+typename BasicSimulation<P>::Status BasicSimulation<P>::status()
+{
+	return _status;
+}
+
+/**
+ * Scans, replans if anything changed, and drives one cell.
+ *
+ * @return  Status
+ */
+template <typename P>
+typename BasicSimulation<P>::Status BasicSimulation<P>::step()
+{
+	if ( ! _init)
+	{
+		init();
+	}
+
+	if (_status != STATUS_RUNNING)
+		return _status;
+
+	DSTARLITE_TRACE_SCOPE("step");
+
+	if (_planner->start() == _planner->goal())
+	{
+		_status = STATUS_GOAL;
+		return _status;
+	}
+
+	Timer timer;
+
+	if (_stale(update_map()))
+	{
+		Timer replan;
+
+		bool result = _replan();
+
+		double latency = replan.elapsed();
+		_stats.latencies.push_back(latency);
+		_stats.latency_total += latency;
+		_stats.replans++;
+
+		if (latency > _stats.latency_max)
+		{
+			_stats.latency_max = latency;
+		}
+
+		if ( ! result && ! _planner->suspended())
+		{
+			_status = STATUS_NO_PATH;
+			_stats.wall += timer.elapsed();
+			return _status;
+		}
+	}
+
+	Map::Cell* next = _next();
+
+	// A suspended search may have no guess yet, it goes on next step
+	if (next == NULL)
+	{
+		if ( ! _planner->suspended())
+		{
+			_status = STATUS_NO_PATH;
+		}
+
+		_stats.wall += timer.elapsed();
+		return _status;
+	}
+
+	_stats.cost += _cost(_planner->start(), next);
+	_stats.steps++;
+
+	_planner->start(next);
+	_path_traversed.push_back(next);
+
+	_stats.wall += timer.elapsed();
+
+	return _status;
+}
+
+/*
+ * Scans map for updated cells.
+ *
+ * @return  bool  updates found
+ */
+template <typename P>
+bool BasicSimulation<P>::update_map()
+{
+	DSTARLITE_TRACE_SCOPE("update_map");
+
+	Map::Cell* current = _planner->start();
+
+	unsigned int x, y;
+	x = current->x();
+	y = current->y();
+
+	// Radius^2
+	unsigned int radius = _config.scan_radius;
+	unsigned int radius2 = radius * radius;
+
+	unsigned int rows, cols;
+	rows = _map->rows();
+	cols = _map->cols();
+
+	// Half widths of the circle, by row offset
+	if (_spans.size() != radius)
+	{
+		_spans.resize(radius);
+
+		for (unsigned int dy = 0; dy < radius; dy++)
+		{
+			// Widest column offset inside the circle (dx^2 < rest)
+			unsigned int rest = radius2 - dy * dy;
+			unsigned int dx = (unsigned int) sqrt((double) rest);
+
+			while (dx * dx >= rest)
+				dx--;
+
+			while ((dx + 1) * (dx + 1) < rest)
+				dx++;
+
+			_spans[dy] = dx;
+		}
+
+		_scanned = false;
+	}
+
+	// After a one cell move the previous circle is already up to date, only
+	// the cells outside it need a look
+	bool incremental = _config.sensor == Config::SENSOR_INCREMENTAL && _scanned
+		&& x + 1 >= _scan_x && x <= _scan_x + 1 && y + 1 >= _scan_y && y <= _scan_y + 1;
+
+	// Rows the scan circle touches
+	unsigned int max_y, min_y;
+	max_y = (y + radius < rows) ? y + radius : rows;
+	min_y = (y > radius) ? y - radius : 0;
+
+	_changed.clear();
+
+	for (unsigned int i = min_y; i < max_y; i++)
+	{
+		unsigned int dy = (i > y) ? i - y : y - i;
+
+		if (dy >= radius)
+			continue;
+
+		// One span per row, clipped to the map
+		unsigned int dx = _spans[dy];
+		unsigned int min_x = (x > dx) ? x - dx : 0;
+		unsigned int max_x = (x + dx + 1 < cols) ? x + dx + 1 : cols;
+
+		unsigned int old_dy = (i > _scan_y) ? i - _scan_y : _scan_y - i;
+
+		if ( ! incremental || old_dy >= radius)
+		{
+			_diff(i, min_x, max_x);
+			continue;
+		}
+
+		// The part of the span outside the previous circle's span (on either side)
+		unsigned int old_dx = _spans[old_dy];
+		unsigned int old_min_x = (_scan_x > old_dx) ? _scan_x - old_dx : 0;
+		unsigned int old_max_x = (_scan_x + old_dx + 1 < cols) ? _scan_x + old_dx + 1 : cols;
+
+		_diff(i, min_x, min(max_x, old_min_x));
+		_diff(i, max(min_x, old_max_x), max_x);
+	}
+
+	_scanned = true;
+	_scan_x = x;
+	_scan_y = y;
+
+	// Changed cells, handed to the planner in one batch
+	vector<pair<Map::Cell*,double> > changes;
+	changes.reserve(_changed.size());
+
+	for (unsigned int i = 0; i < _changed.size(); i++)
+	{
+		unsigned int k = _changed[i];
+
+		_robot[k] = _real[k];
+
+		changes.push_back(pair<Map::Cell*,double>((*_map)(k / cols, k % cols), Bitmap::cost(_robot[k])));
+	}
+
+	DSTARLITE_TRACE_COUNTER("changed_cells", changes.size());
+
+	_planner->update_batch(changes);
+
+	return ! changes.empty();
+}
+
+/**
+ * Calculates the cost of a move (the same as the planner's).
+ *
+ * @param   Map::Cell*   cell a
+ * @param   Map::Cell*   neighboring cell b
+ * @return  double       cost between a and b
+ */
+template <typename P>
+double BasicSimulation<P>::_cost(Map::Cell* a, Map::Cell* b)
+{
+	unsigned int dx = (a->x() > b->x()) ? a->x() - b->x() : b->x() - a->x();
+	unsigned int dy = (a->y() > b->y()) ? a->y() - b->y() : b->y() - a->y();
+
+	// Knight move, also pays for the two cells it passes between
+	if ((dx + dy) == 3)
+	{
+		Map::Cell* m1;
+		Map::Cell* m2;
+
+		if (dy == 2)
+		{
+			m1 = (*_map)((a->y() + b->y()) / 2, a->x());
+			m2 = (*_map)((a->y() + b->y()) / 2, b->x());
+		}
+		else
+		{
+			m1 = (*_map)(a->y(), (a->x() + b->x()) / 2);
+			m2 = (*_map)(b->y(), (a->x() + b->x()) / 2);
+		}
+
+		return Math::SQRT5 * ((_planner->cost(a) + _planner->cost(b) + _planner->cost(m1) + _planner->cost(m2)) / 4);
+	}
+
+	double scale = 1.0;
+
+	if (dx != 0 && dy != 0)
+	{
+		scale = Math::SQRT2;
+	}
+
+	return scale * ((_planner->cost(a) + _planner->cost(b)) / 2);
+}
+
+/**
+ * Compares a span of a row of the real and robot maps.
+ *
+ * @param   unsigned int   row
+ * @param   unsigned int   first column
+ * @param   unsigned int   column past the end
+ * @return  void
+ */
+template <typename P>
+void BasicSimulation<P>::_diff(unsigned int row, unsigned int begin, unsigned int end)
+{
+	if (begin >= end)
+		return;
+
+	unsigned int k = row * _map->cols();
+
+	Diff::span(_real, _robot, k + begin, k + end, _changed);
+}
+
+/**
+ * Takes the next cell to drive to, on the planner's best guess while its
+ * search is suspended.
+ *
+ * @return  Map::Cell*   next cell (NULL if there is none yet)
+ */
+template <typename P>
+Map::Cell* BasicSimulation<P>::_next()
+{
+	if (_planner->suspended())
+	{
+		_path_planned.clear();
+
+		Map::Cell* next = _planner->next_step();
+
+		if (next != NULL)
+		{
+			_stats.interim++;
+		}
+
+		return next;
+	}
+
+	Map::Cell* next = _path_planned.front();
+	_path_planned.pop_front();
+
+	return next;
+}
+
+namespace DStarLite
+{
+	/**
+	 * Takes the next cell to drive to.
+	 *
+	 * The abstract path only holds entrances, the planner refines the hop in
+	 * front of the robot to cells.
+	 *
+	 * @return  Map::Cell*   next cell (NULL if there is none)
+	 */
+	template <>
+	Map::Cell* BasicSimulation<HierarchicalPlanner>::_next()
+	{
+		return _planner->next_step();
+	}
+};
+
+/**
+ * Replans and refreshes the planned path.
+ *
+ * @return  bool   solution found
+ */
+template <typename P>
+bool BasicSimulation<P>::_replan()
+{
+	if ( ! _planner->replan())
+		return false;
+
+	_path_planned = _planner->path();
+
+	if ( ! _path_planned.empty())
+	{
+		_path_planned.pop_front();
+	}
+
+	return ! _path_planned.empty() || _planner->start() == _planner->goal();
+}
+
+/**
+ * Determines if the planner has to replan before the next step: the map
+ * changed somewhere the path cares about, the last search is still going,
+ * or an anytime path can still improve.
+ *
+ * @param   bool   the scan changed the map
+ * @return  bool
+ */
+template <typename P>
+bool BasicSimulation<P>::_stale(bool changed)
+{
+	return (changed && _planner->affected()) || _planner->suspended() || _planner->bound() > 1;
+}
+
+namespace DStarLite
+{
+	/**
+	 * Determines if the planner has to replan before the next step.
+	 *
+	 * Changes away from the path and the refined hop wait for a later replan,
+	 * and a used up hop needs one from the cell the robot stopped on.
+	 *
+	 * @param   bool   the scan changed the map
+	 * @return  bool
+	 */
+	template <>
+	bool BasicSimulation<HierarchicalPlanner>::_stale(bool changed)
+	{
+		return (changed && _planner->affected()) || _planner->next_step() == NULL;
+	}
+};
+
+template class BasicSimulation<BasicPlanner<double, Neighborhood4> >;
+template class BasicSimulation<BasicPlanner<double, Neighborhood8> >;
+template class BasicSimulation<BasicPlanner<double, Neighborhood16> >;
+template class BasicSimulation<BasicPlanner<float, Neighborhood4> >;
+template class BasicSimulation<BasicPlanner<float, Neighborhood8> >;
+template class BasicSimulation<BasicPlanner<float, Neighborhood16> >;
+template class BasicSimulation<BasicPlanner<Fixed, Neighborhood4> >;
+template class BasicSimulation<BasicPlanner<Fixed, Neighborhood8> >;
+template class BasicSimulation<BasicPlanner<Fixed, Neighborhood16> >;
+template class BasicSimulation<HierarchicalPlanner>;
@@ -0,0 +1,436 @@
+/**
+ * Simulation.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#ifndef DSTARLITE_SIMULATION_H
+#define DSTARLITE_SIMULATION_H
+
+#include <list>
+#include <utility>
+#include <vector>
+
+#include "cost_layer.h"
+#include "map.h"
+#include "planner.h"
+
+using namespace std;
+using namespace DStarLite;
+
+namespace DStarLite
+{
+	/**
+	 * One robot driving from start to goal through a world it only learns by
+	 * scanning, without a window (the Simulator draws one).
+	 *
+	 * The robot starts with its own map of the world and scans a circle
+	 * around itself every step. Cells that differ from the real map are
+	 * copied into the robot map and handed to the planner, which replans.
+	 *
+	 * Templated on the planner (a BasicPlanner or the HierarchicalPlanner).
+	 */
+	template <typename P>
+	class BasicSimulation
+	{
+		public:
+
+			/**
+			 * @var  typedef  planner of the simulation
+			 */
+			typedef P Planner;
+
+			/**
+			 * Config class.
+			 */
+			class Config
+			{
+				public:
+
+					/**
+					 * Scan modes.
+					 */
+					enum Sensor
+					{
+						/**
+						 * Every cell of the circle, every step.
+						 */
+						SENSOR_FULL,
+
+						/**
+						 * Only the cells a one cell move brings into the circle
+						 * (default). Anything else scans the full circle.
+						 */
+						SENSOR_INCREMENTAL
+					};
+
+					/**
+					 * @var  CostLayer::Format  map cost storage
+					 */
+					CostLayer::Format format;
+
+					/**
+					 * @var  pair<unsigned int, unsigned int>  goal position (row, column)
+					 */
+					pair<unsigned int, unsigned int> goal;
+
+					/**
+					 * @var  Planner::Config  planner config options
+					 */
+					typename Planner::Config planner;
+
+					/**
+					 * @var  unsigned int  scanner radius
+					 */
+					unsigned int scan_radius;
+
+					/**
+					 * @var  Sensor  scan mode
+					 */
+					Sensor sensor;
+
+					/**
+					 * @var  pair<unsigned int, unsigned int>  start position (row, column)
+					 */
+					pair<unsigned int, unsigned int> start;
+
+					/**
+					 * @var  unsigned int  map tile width and height (0 for one contiguous block, see Map::Config)
+					 */
+					unsigned int tile_size;
+
+					/**
+					 * Constructor.
+					 */
+					Config();
+			};
+
+			/**
+			 * Run stats.
+			 */
+			class Stats
+			{
+				public:
+
+					/**
+					 * @var  double  cost of the path driven so far
+					 */
+					double cost;
+
+					/**
+					 * @var  double  seconds spent on the first plan
+					 */
+					double initial;
+
+					/**
+					 * @var  unsigned int  steps driven on the planner's best guess while its search was suspended
+					 */
+					unsigned int interim;
+
+					/**
+					 * @var  vector<double>  seconds of every replan after the first plan
+					 */
+					vector<double> latencies;
+
+					/**
+					 * @var  double  slowest replan after the first plan, seconds
+					 */
+					double latency_max;
+
+					/**
+					 * @var  double  seconds spent on replans after the first plan
+					 */
+					double latency_total;
+
+					/**
+					 * @var  unsigned int  replans after the first plan
+					 */
+					unsigned int replans;
+
+					/**
+					 * @var  unsigned int  steps driven
+					 */
+					unsigned int steps;
+
+					/**
+					 * @var  double  seconds spent in init() and step() (scanning, planning and driving)
+					 */
+					double wall;
+
+					/**
+					 * Constructor.
+					 */
+					Stats();
+			};
+
+			/**
+			 * Run states.
+			 */
+			enum Status
+			{
+				/**
+				 * Still driving.
+				 */
+				STATUS_RUNNING,
+
+				/**
+				 * At the goal.
+				 */
+				STATUS_GOAL,
+
+				/**
+				 * No path to the goal.
+				 */
+				STATUS_NO_PATH
+			};
+
+			/**
+			 * Constructor.
+			 *
+			 * Both maps are gray values, row by row from the top (see Bitmap).
+			 * The robot map is updated as the robot scans.
+			 *
+			 * @param  unsigned char*   real map
+			 * @param  unsigned char*   robot map
+			 * @param  unsigned int     rows
+			 * @param  unsigned int     columns
+			 * @param  Config           config options
+			 */
+			BasicSimulation(unsigned char* real, unsigned char* robot, unsigned int rows, unsigned int cols, Config config);
+
+			/**
+			 * Deconstructor.
+			 */
+			~BasicSimulation();
+
+			/**
+			 * Gets the current position.
+			 *
+			 * @return  Map::Cell*
+			 */
+			Map::Cell* current();
+
+			/**
+			 * Gets the goal.
+			 *
+			 * @return  Map::Cell*
+			 */
+			Map::Cell* goal();
+
+			/**
+			 * Plans the first path (step() does it if needed).
+			 *
+			 * @return  Status
+			 */
+			Status init();
+
+			/**
+			 * Gets the robot map.
+			 *
+			 * @return  Map*
+			 */
+			Map* map();
+
+			/**
+			 * Gets the cells left to drive on the planned path.
+			 *
+			 * @return  list<Map::Cell*>
+			 */
+			const list<Map::Cell*>& path_planned();
+
+			/**
+			 * Gets the cells driven so far, starting with the start.
+			 *
+			 * @return  list<Map::Cell*>
+			 */
+			const list<Map::Cell*>& path_traversed();
+
+			/**
+			 * Gets the planner.
+			 *
+			 * @return  Planner*
+			 */
+			Planner* planner();
+
+			/**
+			 * Runs until the robot reaches the goal or gets stuck, as fast as possible.
+			 *
+			 * @return  Status
+			 */
+			Status run();
+
+			/**
+			 * Scans the full circle on the next step (after the real map changed
+			 * where the robot already looked).
+			 *
+			 * @return  void
+			 */
+			void rescan();
+
+			/**
+			 * Gets the scanner radius.
+			 *
+			 * @return  unsigned int
+			 */
+			unsigned int scan_radius();
+
+			/**
+			 * Sets the scanner radius (the next step scans the full circle).
+			 *
+			 * @param   unsigned int   radius
+			 * @return  void
+			 */
+			void scan_radius(unsigned int radius);
+
+			/**
+			 * Gets the stats so far.
+			 *
+			 * @return  Stats
+			 */
+			const Stats& stats();
+
+			/**
+			 * Gets the current state.
+			 *
+			 * @return  Status
+			 */
+			Status status();
+
+			/**
+			 * Scans, replans if anything changed, and drives one cell.
+			 *
+			 * @return  Status
+			 */
+			Status step();
+
+			/*
+			 * Scans map for updated cells.
+			 *
+			 * @return  bool  updates found
+			 */
+			bool update_map();
+
+		protected:
+
+			/**
+			 * @var  vector<unsigned int>  cells the last scan found changed (reused)
+			 */
+			vector<unsigned int> _changed;
+
+			/**
+			 * @var  Config  simulation config options
+			 */
+			Config _config;
+
+			/**
+			 * @var  bool  first plan done
+			 */
+			bool _init;
+
+			/**
+			 * @var  Map*  robot map
+			 */
+			Map* _map;
+
+			/**
+			 * @var  list<Map::Cell*>  cells left to drive
+			 */
+			list<Map::Cell*> _path_planned;
+
+			/**
+			 * @var  list<Map::Cell*>  cells driven
+			 */
+			list<Map::Cell*> _path_traversed;
+
+			/**
+			 * @var  Planner*  planner
+			 */
+			Planner* _planner;
+
+			/**
+			 * @var  unsigned char*  real map
+			 */
+			unsigned char* _real;
+
+			/**
+			 * @var  unsigned char*  robot map
+			 */
+			unsigned char* _robot;
+
+			/**
+			 * @var  bool  _scan_x and _scan_y hold the last scan position
+			 */
+			bool _scanned;
+
+			/**
+			 * @var  unsigned int  last scan position
+			 */
+			unsigned int _scan_x;
+			unsigned int _scan_y;
+
+			/**
+			 * @var  vector<unsigned int>  half width of the scan circle by row offset (one per row offset below the radius)
+			 */
+			vector<unsigned int> _spans;
+
+			/**
+			 * @var  Stats  stats so far
+			 */
+			Stats _stats;
+
+			/**
+			 * @var  Status  current state
+			 */
+			Status _status;
+
+			/**
+			 * Calculates the cost of a move (the same as the planner's).
+			 *
+			 * @param   Map::Cell*   cell a
+			 * @param   Map::Cell*   neighboring cell b
+			 * @return  double       cost between a and b
+			 */
+			double _cost(Map::Cell* a, Map::Cell* b);
+
+			/**
+			 * Compares a span of a row of the real and robot maps.
+			 *
+			 * @param   unsigned int   row
+			 * @param   unsigned int   first column
+			 * @param   unsigned int   column past the end
+			 * @return  void
+			 */
+			void _diff(unsigned int row, unsigned int begin, unsigned int end);
+
+			/**
+			 * Takes the next cell to drive to.
+			 *
+			 * @return  Map::Cell*   next cell (NULL if there is none yet)
+			 */
+			Map::Cell* _next();
+
+			/**
+			 * Replans and refreshes the planned path.
+			 *
+			 * @return  bool   solution found
+			 */
+			bool _replan();
+
+			/**
+			 * Determines if the planner has to replan before the next step.
+			 *
+			 * @param   bool   the scan changed the map
+			 * @return  bool
+			 */
+			bool _stale(bool changed);
+	};
+
+	/**
+	 * @var  typedef  simulation with the reference planner
+	 */
+	typedef BasicSimulation<Planner> Simulation;
+};
+
+#endif // DSTARLITE_SIMULATION_H
@@ -7,16 +7,7 @@
  * @license		MIT
  */
 #include "simulator.h"
-
-/**
- * @var  double  cost difference between bitmap and tile;
- */
-const double Simulator::COST_DIFFERENCE = 255.0;
-
-/**
- * @var  double  unwalkable value of bitmap
- */
-const double Simulator::UNWALKABLE_CELL = 0.0;
+#include "trace.h"
 
 /*
  * @var  int  window width padding
@@ -49,8 +40,13 @@ void Simulator::callback(Fl_Widget* w, void* p)
 
 	while (simulator->execute() == 0)
 	{
-		simulator->redraw();
-		Fl::check();
+		{
+			DSTARLITE_TRACE_SCOPE("redraw");
+
+			simulator->redraw();
+			Fl::check();
+		}
+
 		Fl::wait(0.08);
 	}
 }
@@ -158,40 +154,18 @@ Simulator::Simulator(char* name, Config config)
 	// Sert the scan radius
 	_robot_widget->scan_radius = config.scan_radius;
 
-	// Make the map
-	_map = new Map(img_height, img_width);
+	// Make the simulation (it keeps the robot buffer up to date)
+	Simulation::Config sim_config;
+	sim_config.start = config.start;
+	sim_config.goal = config.goal;
+	sim_config.scan_radius = config.scan_radius;
 
-	// Set current and goal position
-	_real_widget->current = _robot_widget->current = (*_map)(config.start.first, config.start.second);
-	_real_widget->goal = _robot_widget->goal = (*_map)(config.goal.first, config.goal.second);
+	_simulation = new Simulation(_real_widget->data, _robot_widget->data, img_height, img_width, sim_config);
 
-	// Build map
-	for (int i = 0; i < img_height; i++)
-	{
-		for (int j = 0; j < img_width; j++)
-		{
-			int k = (i * img_width) + j;
-			double v = (double) _robot_widget->data[k];
+	// Set goal position
+	_real_widget->goal = _robot_widget->goal = _simulation->goal();
 
-			// Cell is unwalkable
-			if (v == Simulator::UNWALKABLE_CELL)
-			{
-				v = Map::Cell::COST_UNWALKABLE;
-			}
-			else
-			{
-				v = Simulator::COST_DIFFERENCE - v + 1.0;
-			}
-
-			(*_map)(i, j)->cost = v;
-		}
-	}
-
-	// Make planner
-	_planner = new Planner(_map, _robot_widget->current, _robot_widget->goal);
-
-	// Push start position
-	_real_widget->path_traversed.push_back(_planner->start());
+	_sync();
 }
 
 /**
@@ -199,8 +173,7 @@ Simulator::Simulator(char* name, Config config)
  */
 Simulator::~Simulator()
 {
-	delete _map;
-	delete _planner;
+	delete _simulation;
 	delete _window;
 }
 
@@ -223,37 +196,22 @@ int Simulator::draw()
  */
 int Simulator::execute()
 {
-	if (_planner->start() == _planner->goal())
+	Simulation::Status status = _simulation->step();
+
+	_sync();
+
+	if (status == Simulation::STATUS_GOAL)
 	{
 		fl_alert("Goal Reached!");
-		_real_widget->current = _robot_widget->current = _planner->goal();
 		return 1;
 	}
 
-	// Check if map was updated
-	if (update_map())
+	if (status == Simulation::STATUS_NO_PATH)
 	{
-		// Replan the path
-		if ( ! _planner->replan())
-		{
-			fl_alert("No Solution Found!");
-			throw;
-		}
-
-		_robot_widget->path_planned = _planner->path();
-
-		if ( ! _robot_widget->path_planned.empty())
-		{
-			_robot_widget->path_planned.pop_front();
-		}
+		fl_alert("No Solution Found!");
+		throw;
 	}
 
-	// Step
-	_real_widget->path_traversed.push_back(_robot_widget->path_planned.front());
-	_planner->start(_robot_widget->path_planned.front());
-	_real_widget->current = _robot_widget->current = _planner->start();
-	_robot_widget->path_planned.pop_front();
-
 	return 0;
 }
 
@@ -269,13 +227,13 @@ bool Simulator::init()
 
 	_init = true;
 
-	if ( ! _planner->replan())
+	if (_simulation->init() == Simulation::STATUS_NO_PATH)
 	{
 		fl_alert("No Solution Found!");
 		throw;
 	}
 
-	_robot_widget->path_planned = _planner->path();
+	_sync();
 
 	return false;
 }
@@ -290,71 +248,14 @@ void Simulator::redraw()
 	_window->redraw();
 }
 
-/*
- * Scans map for updated tiles.
+/**
+ * Copies the simulation state to the widgets.
  *
- * @return  bool  updates found
+ * @return  void
  */
-bool Simulator::update_map()
+void Simulator::_sync()
 {
-	bool error = false;
-
-	Map::Cell* current = _robot_widget->current;
-
-	unsigned int x, y;
-	x = current->x();
-	y = current->y();
-
-	// Radius^2
-	unsigned int radius = _robot_widget->scan_radius;
-	unsigned int radius2 = radius * radius;
-
-	unsigned int rows, cols;
-	rows = _map->rows();
-	cols = _map->cols();
-
-	// Make an imaginary box around the scan circle
-	unsigned int max_x, max_y, min_x, min_y;
-	max_x = (x + radius < cols) ? x + radius : cols;
-	max_y = (y + radius < rows) ? y + radius : rows;
-	min_x = (x > radius) ? x - radius : 0;
-	min_y = (y > radius) ? y - radius : 0;
-
-	for (unsigned int i = min_y; i < max_y; i++)
-	{
-		int dy = y - i;
-		unsigned int dy2 = dy * dy;
-
-		for (unsigned int j = min_x; j < max_x; j++)
-		{
-			int dx = x - j;
-			
-			if ((dx * dx) + dy2 < radius2)
-			{
-				unsigned int k = (i * cols) + j;
-
-				// Check if an update is required
-				if (_robot_widget->data[k] != _real_widget->data[k])
-				{
-					error = true;
-
-					_robot_widget->data[k] = _real_widget->data[k];
-					double v = (double) _robot_widget->data[k];
-
-					if (v == Simulator::UNWALKABLE_CELL)
-					{
-						v = Map::Cell::COST_UNWALKABLE;
-					}
-					else
-					{
-						v = Simulator::COST_DIFFERENCE - v + 1.0;
-					}
-
-					_planner->update((*_map)(i, j), v);
-				}
-			}
-		}
-	}
-
-	return error;
-}
\ No newline at end of file
+	_real_widget->current = _robot_widget->current = _simulation->current();
+	_real_widget->path_traversed = _simulation->path_traversed();
+	_robot_widget->path_planned = _simulation->path_planned();
+}
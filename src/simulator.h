@@ -15,8 +15,8 @@
 #include <FL/Fl_Double_Window.H>
 #include <FL/fl_ask.H>
 
-#include "planner.h"
 #include "map.h"
+#include "simulation.h"
 #include "widgets/widget_real.h"
 #include "widgets/widget_robot.h"
 
@@ -24,6 +24,9 @@ using namespace DStarLite;
 
 namespace DStarLite
 {
+	/**
+	 * Windowed front end of a Simulation.
+	 */
 	class Simulator
 	{
 		public:
@@ -76,16 +79,6 @@ namespace DStarLite
 			 */
 			static const int WINDOW_IMG_PADDING;
 
-			/**
-			 * @var  double  cost difference between bitmap and tile
-			 */
-			static const double COST_DIFFERENCE;
-
-			/**
-			 * @var  double  unwalkable value of bitmap
-			 */
-			static const double UNWALKABLE_CELL;
-
 			/**
 			 * Executes the simulator when the start button is clicked.
 			 *
@@ -136,13 +129,6 @@ namespace DStarLite
 			 */
 			void redraw();
 
-			/*
-			 * Scans map for updated cells.
-			 *
-			 * @return  bool  updates found
-			 */
-			bool update_map();
-
 		protected:
 
 			/**
@@ -155,21 +141,11 @@ namespace DStarLite
 			 */
 			bool _init;
 
-			/**
-			 * @var  Map*  real map, with all obstacles
-			 */
-			Map* _map;
-
 			/**
 			 * @var  char*  name of the simulator
 			 */
 			char* _name;
 
-			/**
-			 * @var  Planner*  planner
-			 */
-			Planner* _planner;
-
 			/**
 			 * @var  RealWidget*  real widget
 			 */
@@ -180,6 +156,11 @@ namespace DStarLite
 			 */
 			RobotWidget* _robot_widget;
 
+			/**
+			 * @var  Simulation*  simulation
+			 */
+			Simulation* _simulation;
+
 			/**
 			 * @var  Fl_Button*  start button
 			 */
@@ -189,6 +170,13 @@ namespace DStarLite
 			 * @var  Fl_Window*  window
 			 */
 			Fl_Window* _window;
+
+			/**
+			 * Copies the simulation state to the widgets.
+			 *
+			 * @return  void
+			 */
+			void _sync();
 	};
 };
 
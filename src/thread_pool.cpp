@@ -0,0 +1,290 @@
+/**
+ * Thread Pool.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#ifndef WIN32
+	#include <unistd.h>
+#endif
+#include "thread_pool.h"
+
+using namespace DStarLite;
+
+/**
+ * Gets the number of hardware threads.
+ *
+ * @return  unsigned int   (at least 1)
+ */
+unsigned int ThreadPool::hardware()
+{
+#ifdef WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	long n = (long) info.dwNumberOfProcessors;
+#else
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+	return (n > 0) ? (unsigned int) n : 1;
+}
+
+/**
+ * Constructor.
+ *
+ * @param  unsigned int   threads (including the caller, 0 for hardware())
+ */
+ThreadPool::ThreadPool(unsigned int threads)
+{
+	if (threads == 0)
+	{
+		threads = hardware();
+	}
+
+	_busy = 0;
+	_data = NULL;
+	_generation = 0;
+	_n = 0;
+	_next = 0;
+	_stop = false;
+	_task = NULL;
+
+#ifdef WIN32
+	InitializeCriticalSection(&_mutex);
+	InitializeConditionVariable(&_wake);
+	InitializeConditionVariable(&_done);
+#else
+	pthread_mutex_init(&_mutex, NULL);
+	pthread_cond_init(&_wake, NULL);
+	pthread_cond_init(&_done, NULL);
+#endif
+
+	// The caller is the first thread
+	for (unsigned int i = 1; i < threads; i++)
+	{
+		Thread t;
+
+#ifdef WIN32
+		t = CreateThread(NULL, 0, ThreadPool::_main, (LPVOID) this, 0, NULL);
+
+		if (t == NULL)
+			break;
+#else
+		if (pthread_create(&t, NULL, ThreadPool::_main, (void*) this) != 0)
+			break;
+#endif
+
+		_threads.push_back(t);
+	}
+}
+
+/**
+ * Deconstructor.
+ */
+ThreadPool::~ThreadPool()
+{
+	_lock();
+	_stop = true;
+	_broadcast(&_wake);
+	_unlock();
+
+	for (unsigned int i = 0; i < _threads.size(); i++)
+	{
+#ifdef WIN32
+		WaitForSingleObject(_threads[i], INFINITE);
+		CloseHandle(_threads[i]);
+#else
+		pthread_join(_threads[i], NULL);
+#endif
+	}
+
+#ifdef WIN32
+	DeleteCriticalSection(&_mutex);
+#else
+	pthread_cond_destroy(&_done);
+	pthread_cond_destroy(&_wake);
+	pthread_mutex_destroy(&_mutex);
+#endif
+}
+
+/**
+ * Runs a task for indices 0 to n - 1 and waits for all of them.
+ *
+ * @param   Task           task
+ * @param   void*          data passed to the task
+ * @param   unsigned int   number of indices
+ * @return  void
+ */
+void ThreadPool::run(Task task, void* data, unsigned int n)
+{
+	if (n == 0)
+		return;
+
+	_lock();
+
+	_task = task;
+	_data = data;
+	_n = n;
+	_next = 0;
+	_busy = (unsigned int) _threads.size();
+	_generation++;
+
+	_broadcast(&_wake);
+
+	_drain();
+
+	// Workers may still be finishing their last index
+	while (_busy > 0)
+	{
+		_wait(&_done);
+	}
+
+	_unlock();
+}
+
+/**
+ * Gets the number of threads (including the caller).
+ *
+ * @return  unsigned int
+ */
+unsigned int ThreadPool::size()
+{
+	return (unsigned int) _threads.size() + 1;
+}
+
+#ifdef WIN32
+/**
+ * Worker entry point.
+ *
+ * @param   LPVOID   pool
+ * @return  DWORD
+ */
+DWORD WINAPI ThreadPool::_main(LPVOID pool)
+{
+	((ThreadPool*) pool)->_work();
+	return 0;
+}
+#else
+/**
+ * Worker entry point.
+ *
+ * @param   void*   pool
+ * @return  void*
+ */
+void* ThreadPool::_main(void* pool)
+{
+	((ThreadPool*) pool)->_work();
+	return NULL;
+}
+#endif
+
+/**
+ * Wakes every thread waiting on a condition.
+ *
+ * @param   Condition*
+ * @return  void
+ */
+void ThreadPool::_broadcast(Condition* c)
+{
+#ifdef WIN32
+	WakeAllConditionVariable(c);
+#else
+	pthread_cond_broadcast(c);
+#endif
+}
+
+/**
+ * Runs indices until none are left (mutex held on entry and exit).
+ *
+ * @return  void
+ */
+void ThreadPool::_drain()
+{
+	while (_next < _n)
+	{
+		unsigned int i = _next++;
+
+		_unlock();
+		_task(_data, i);
+		_lock();
+	}
+}
+
+/**
+ * Locks the mutex.
+ *
+ * @return  void
+ */
+void ThreadPool::_lock()
+{
+#ifdef WIN32
+	EnterCriticalSection(&_mutex);
+#else
+	pthread_mutex_lock(&_mutex);
+#endif
+}
+
+/**
+ * Unlocks the mutex.
+ *
+ * @return  void
+ */
+void ThreadPool::_unlock()
+{
+#ifdef WIN32
+	LeaveCriticalSection(&_mutex);
+#else
+	pthread_mutex_unlock(&_mutex);
+#endif
+}
+
+/**
+ * Waits on a condition (mutex held).
+ *
+ * @param   Condition*
+ * @return  void
+ */
+void ThreadPool::_wait(Condition* c)
+{
+#ifdef WIN32
+	SleepConditionVariableCS(c, &_mutex, INFINITE);
+#else
+	pthread_cond_wait(c, &_mutex);
+#endif
+}
+
+/**
+ * Worker loop.
+ *
+ * @return  void
+ */
+void ThreadPool::_work()
+{
+	unsigned int seen = 0;
+
+	_lock();
+
+	while (true)
+	{
+		while ( ! _stop && _generation == seen)
+		{
+			_wait(&_wake);
+		}
+
+		if (_stop)
+			break;
+
+		seen = _generation;
+
+		_drain();
+
+		if (--_busy == 0)
+		{
+			_broadcast(&_done);
+		}
+	}
+
+	_unlock();
+}
@@ -0,0 +1,207 @@
+/**
+ * Thread Pool.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#ifndef DSTARLITE_THREAD_POOL_H
+#define DSTARLITE_THREAD_POOL_H
+
+#include <vector>
+#ifdef WIN32
+	#include <windows.h>
+#else
+	#include <pthread.h>
+#endif
+
+using namespace std;
+
+namespace DStarLite
+{
+	/**
+	 * Fixed set of threads that run the indices of a task in parallel.
+	 *
+	 * The calling thread works too, so a pool of one thread runs everything
+	 * on the caller.
+	 */
+	class ThreadPool
+	{
+		public:
+
+			/**
+			 * @var  typedef  task (data, index)
+			 */
+			typedef void (*Task)(void* data, unsigned int i);
+
+			/**
+			 * Gets the number of hardware threads.
+			 *
+			 * @return  unsigned int   (at least 1)
+			 */
+			static unsigned int hardware();
+
+			/**
+			 * Constructor.
+			 *
+			 * @param  unsigned int   threads (including the caller, 0 for hardware())
+			 */
+			ThreadPool(unsigned int threads = 0);
+
+			/**
+			 * Deconstructor.
+			 */
+			~ThreadPool();
+
+			/**
+			 * Runs a task for indices 0 to n - 1 and waits for all of them.
+			 *
+			 * Indices are handed out one at a time, so uneven tasks balance out.
+			 *
+			 * @param   Task           task
+			 * @param   void*          data passed to the task
+			 * @param   unsigned int   number of indices
+			 * @return  void
+			 */
+			void run(Task task, void* data, unsigned int n);
+
+			/**
+			 * Gets the number of threads (including the caller).
+			 *
+			 * @return  unsigned int
+			 */
+			unsigned int size();
+
+		protected:
+
+#ifdef WIN32
+			typedef HANDLE Thread;
+			typedef CRITICAL_SECTION Mutex;
+			typedef CONDITION_VARIABLE Condition;
+#else
+			typedef pthread_t Thread;
+			typedef pthread_mutex_t Mutex;
+			typedef pthread_cond_t Condition;
+#endif
+
+			/**
+			 * @var  unsigned int  workers still on the current task
+			 */
+			unsigned int _busy;
+
+			/**
+			 * @var  void*  task data
+			 */
+			void* _data;
+
+			/**
+			 * @var  Condition  signaled when the last worker finishes
+			 */
+			Condition _done;
+
+			/**
+			 * @var  unsigned int  task counter (workers wait for it to change)
+			 */
+			unsigned int _generation;
+
+			/**
+			 * @var  Mutex  guards everything below
+			 */
+			Mutex _mutex;
+
+			/**
+			 * @var  unsigned int  number of indices
+			 */
+			unsigned int _n;
+
+			/**
+			 * @var  unsigned int  next index to hand out
+			 */
+			unsigned int _next;
+
+			/**
+			 * @var  bool  workers should exit
+			 */
+			bool _stop;
+
+			/**
+			 * @var  Task  current task
+			 */
+			Task _task;
+
+			/**
+			 * @var  vector<Thread>  worker threads
+			 */
+			vector<Thread> _threads;
+
+			/**
+			 * @var  Condition  signaled when a task starts or the pool stops
+			 */
+			Condition _wake;
+
+#ifdef WIN32
+			/**
+			 * Worker entry point.
+			 *
+			 * @param   LPVOID   pool
+			 * @return  DWORD
+			 */
+			static DWORD WINAPI _main(LPVOID pool);
+#else
+			/**
+			 * Worker entry point.
+			 *
+			 * @param   void*   pool
+			 * @return  void*
+			 */
+			static void* _main(void* pool);
+#endif
+
+			/**
+			 * Wakes every thread waiting on a condition.
+			 *
+			 * @param   Condition*
+			 * @return  void
+			 */
+			void _broadcast(Condition* c);
+
+			/**
+			 * Runs indices until none are left (mutex held on entry and exit).
+			 *
+			 * @return  void
+			 */
+			void _drain();
+
+			/**
+			 * Locks the mutex.
+			 *
+			 * @return  void
+			 */
+			void _lock();
+
+			/**
+			 * Unlocks the mutex.
+			 *
+			 * @return  void
+			 */
+			void _unlock();
+
+			/**
+			 * Waits on a condition (mutex held).
+			 *
+			 * @param   Condition*
+			 * @return  void
+			 */
+			void _wait(Condition* c);
+
+			/**
+			 * Worker loop.
+			 *
+			 * @return  void
+			 */
+			void _work();
+	};
+};
+
+#endif // DSTARLITE_THREAD_POOL_H
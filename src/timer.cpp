@@ -0,0 +1,69 @@
+/**
+ * Timer.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#ifdef WIN32
+	#include <windows.h>
+#else
+	#include <time.h>
+#endif
+#include "timer.h"
+
+using namespace DStarLite;
+
+/**
+ * Gets the current time.
+ *
+ * @return  double   seconds
+ */
+double Timer::now()
+{
+#ifdef WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+
+	return (double) counter.QuadPart / (double) frequency.QuadPart;
+#else
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+
+	return (double) t.tv_sec + (double) t.tv_nsec * 1e-9;
+#endif
+}
+
+/**
+ * Constructor (starts the timer).
+ */
+Timer::Timer()
+{
+	_start = now();
+}
+
+/**
+ * Gets the time since the timer was started.
+ *
+ * @return  double   seconds
+ */
+double Timer::elapsed()
+{
+	return now() - _start;
+}
+
+/**
+ * Restarts the timer.
+ *
+ * @return  double   seconds since the last start
+ */
+double Timer::restart()
+{
+	double t = now();
+	double elapsed = t - _start;
+	_start = t;
+
+	return elapsed;
+}
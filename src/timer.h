@@ -0,0 +1,58 @@
+/**
+ * Timer.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#ifndef DSTARLITE_TIMER_H
+#define DSTARLITE_TIMER_H
+
+namespace DStarLite
+{
+	/**
+	 * Monotonic wall clock.
+	 */
+	class Timer
+	{
+		public:
+
+			/**
+			 * Gets the current time.
+			 *
+			 * Only differences are meaningful.
+			 *
+			 * @return  double   seconds
+			 */
+			static double now();
+
+			/**
+			 * Constructor (starts the timer).
+			 */
+			Timer();
+
+			/**
+			 * Gets the time since the timer was started.
+			 *
+			 * @return  double   seconds
+			 */
+			double elapsed();
+
+			/**
+			 * Restarts the timer.
+			 *
+			 * @return  double   seconds since the last start
+			 */
+			double restart();
+
+		protected:
+
+			/**
+			 * @var  double  start time
+			 */
+			double _start;
+	};
+};
+
+#endif // DSTARLITE_TIMER_H
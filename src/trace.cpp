@@ -0,0 +1,225 @@
+/**
+ * Trace.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+
+#include "timer.h"
+#include "trace.h"
+
+using namespace DStarLite;
+
+/**
+ * @var  static vector<Buffer*>  every thread's buffer (kept for the process)
+ */
+vector<Trace::Buffer*> Trace::_buffers;
+
+/**
+ * @var  static bool  recording
+ */
+volatile bool Trace::_enabled = false;
+
+/**
+ * @var  static string  file to write
+ */
+string Trace::_file;
+
+/**
+ * @var  static Buffer*  this thread's buffer (NULL until its first event)
+ */
+DSTARLITE_THREAD_LOCAL Trace::Buffer* Trace::_local = NULL;
+
+/**
+ * @var  static Mutex  guards _buffers
+ */
+#ifdef WIN32
+Trace::Mutex Trace::_mutex;
+#else
+Trace::Mutex Trace::_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/**
+ * @var  static double  time of open()
+ */
+double Trace::_origin = 0;
+
+/**
+ * Constructor (starts the scope).
+ *
+ * @param  const char*   name
+ */
+Trace::Scope::Scope(const char* name)
+{
+	_name = NULL;
+	_start = 0;
+
+	if (_enabled)
+	{
+		_name = name;
+		_start = Timer::now();
+	}
+}
+
+/**
+ * Deconstructor (ends the scope).
+ */
+Trace::Scope::~Scope()
+{
+	if (_name != NULL && _enabled)
+	{
+		_record(_name, 'X', _start, Timer::now() - _start);
+	}
+}
+
+/**
+ * Writes the trace and stops tracing.
+ *
+ * No traced thread may be running.
+ *
+ * @return  bool   successful
+ */
+bool Trace::close()
+{
+	if ( ! _enabled)
+		return false;
+
+	_enabled = false;
+
+	FILE* file = fopen(_file.c_str(), "w");
+
+	if (file != NULL)
+	{
+		fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+		bool first = true;
+
+		for (unsigned int i = 0; i < _buffers.size(); i++)
+		{
+			Buffer* buffer = _buffers[i];
+
+			fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}",
+				first ? "" : ",\n", buffer->thread, buffer->thread);
+			first = false;
+
+			for (unsigned int j = 0; j < buffer->events.size(); j++)
+			{
+				const Event& e = buffer->events[j];
+
+				// Timestamps are microseconds, counters get one series per thread
+				if (e.phase == 'X')
+				{
+					fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+						e.name, buffer->thread, (e.time - _origin) * 1e6, e.value * 1e6);
+				}
+				else
+				{
+					fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"thread %u\":%.17g}}",
+						e.name, buffer->thread, (e.time - _origin) * 1e6, buffer->thread, e.value);
+				}
+			}
+		}
+
+		fprintf(file, "\n]}\n");
+	}
+
+	for (unsigned int i = 0; i < _buffers.size(); i++)
+	{
+		_buffers[i]->events.clear();
+	}
+
+	return file != NULL && fclose(file) == 0;
+}
+
+/**
+ * Records a counter value.
+ *
+ * @param   const char*   name
+ * @param   double        value
+ * @return  void
+ */
+void Trace::counter(const char* name, double value)
+{
+	if (_enabled)
+	{
+		_record(name, 'C', Timer::now(), value);
+	}
+}
+
+/**
+ * Starts tracing.
+ *
+ * @param   const char*   file to write on close()
+ * @return  void
+ */
+void Trace::open(const char* file)
+{
+#ifdef WIN32
+	static bool initialized = false;
+
+	if ( ! initialized)
+	{
+		InitializeCriticalSection(&_mutex);
+		initialized = true;
+	}
+#endif
+
+	_file = file;
+	_origin = Timer::now();
+	_enabled = true;
+}
+
+/**
+ * Gets this thread's buffer, registering it on first use.
+ *
+ * @return  Buffer*
+ */
+Trace::Buffer* Trace::_buffer()
+{
+	if (_local != NULL)
+		return _local;
+
+	_local = new Buffer();
+	_local->events.reserve(4096);
+
+#ifdef WIN32
+	EnterCriticalSection(&_mutex);
+#else
+	pthread_mutex_lock(&_mutex);
+#endif
+
+	_local->thread = (unsigned int) _buffers.size();
+	_buffers.push_back(_local);
+
+#ifdef WIN32
+	LeaveCriticalSection(&_mutex);
+#else
+	pthread_mutex_unlock(&_mutex);
+#endif
+
+	return _local;
+}
+
+/**
+ * Records an event.
+ *
+ * @param   const char*   name
+ * @param   char          phase
+ * @param   double        time
+ * @param   double        duration or value
+ * @return  void
+ */
+void Trace::_record(const char* name, char phase, double time, double value)
+{
+	Event e;
+	e.name = name;
+	e.phase = phase;
+	e.time = time;
+	e.value = value;
+
+	_buffer()->events.push_back(e);
+}
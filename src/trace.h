@@ -0,0 +1,215 @@
+/**
+ * Trace.
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#ifndef DSTARLITE_TRACE_H
+#define DSTARLITE_TRACE_H
+
+#include <string>
+#include <vector>
+#ifdef WIN32
+	#include <windows.h>
+#else
+	#include <pthread.h>
+#endif
+
+/**
+ * Tracing is only compiled in when DSTARLITE_TRACE is defined, otherwise
+ * every scope and counter compiles to nothing.
+ */
+#ifdef DSTARLITE_TRACE
+	#define DSTARLITE_TRACE_JOIN(a, b) a ## b
+	#define DSTARLITE_TRACE_NAME(line) DSTARLITE_TRACE_JOIN(_trace_scope_, line)
+	#define DSTARLITE_TRACE_SCOPE(name) DStarLite::Trace::Scope DSTARLITE_TRACE_NAME(__LINE__)(name)
+	#define DSTARLITE_TRACE_COUNTER(name, value) DStarLite::Trace::counter(name, (double) (value))
+#else
+	#define DSTARLITE_TRACE_SCOPE(name)
+	#define DSTARLITE_TRACE_COUNTER(name, value)
+#endif
+
+#ifdef WIN32
+	#define DSTARLITE_THREAD_LOCAL __declspec(thread)
+#else
+	#define DSTARLITE_THREAD_LOCAL __thread
+#endif
+
+using namespace std;
+
+namespace DStarLite
+{
+	/**
+	 * Timeline of named scopes and counters, written as Chrome trace event
+	 * JSON (chrome://tracing, ui.perfetto.dev).
+	 *
+	 * Every thread records into its own buffer, so recording takes no lock;
+	 * the buffers are only merged when the trace is closed. Nothing is
+	 * recorded until open() is called. Names must be string literals (only
+	 * the pointer is kept).
+	 */
+	class Trace
+	{
+		public:
+
+			/**
+			 * Records the time between its construction and destruction.
+			 */
+			class Scope
+			{
+				public:
+
+					/**
+					 * Constructor (starts the scope).
+					 *
+					 * @param  const char*   name
+					 */
+					Scope(const char* name);
+
+					/**
+					 * Deconstructor (ends the scope).
+					 */
+					~Scope();
+
+				protected:
+
+					/**
+					 * @var  const char*  name (NULL when not tracing)
+					 */
+					const char* _name;
+
+					/**
+					 * @var  double  start time
+					 */
+					double _start;
+			};
+
+			/**
+			 * Writes the trace and stops tracing.
+			 *
+			 * No traced thread may be running.
+			 *
+			 * @return  bool   successful
+			 */
+			static bool close();
+
+			/**
+			 * Records a counter value.
+			 *
+			 * @param   const char*   name
+			 * @param   double        value
+			 * @return  void
+			 */
+			static void counter(const char* name, double value);
+
+			/**
+			 * Starts tracing.
+			 *
+			 * @param   const char*   file to write on close()
+			 * @return  void
+			 */
+			static void open(const char* file);
+
+		protected:
+
+#ifdef WIN32
+			typedef CRITICAL_SECTION Mutex;
+#else
+			typedef pthread_mutex_t Mutex;
+#endif
+
+			/**
+			 * Event.
+			 */
+			struct Event
+			{
+				/**
+				 * @var  const char*  name
+				 */
+				const char* name;
+
+				/**
+				 * @var  char  phase ('X' complete scope, 'C' counter)
+				 */
+				char phase;
+
+				/**
+				 * @var  double  time (seconds)
+				 */
+				double time;
+
+				/**
+				 * @var  double  duration (seconds) or counter value
+				 */
+				double value;
+			};
+
+			/**
+			 * Events of one thread.
+			 */
+			struct Buffer
+			{
+				/**
+				 * @var  vector<Event>  events
+				 */
+				vector<Event> events;
+
+				/**
+				 * @var  unsigned int  thread number
+				 */
+				unsigned int thread;
+			};
+
+			/**
+			 * @var  static vector<Buffer*>  every thread's buffer (kept for the process)
+			 */
+			static vector<Buffer*> _buffers;
+
+			/**
+			 * @var  static bool  recording
+			 */
+			static volatile bool _enabled;
+
+			/**
+			 * @var  static string  file to write
+			 */
+			static string _file;
+
+			/**
+			 * @var  static Buffer*  this thread's buffer (NULL until its first event)
+			 */
+			static DSTARLITE_THREAD_LOCAL Buffer* _local;
+
+			/**
+			 * @var  static Mutex  guards _buffers
+			 */
+			static Mutex _mutex;
+
+			/**
+			 * @var  static double  time of open()
+			 */
+			static double _origin;
+
+			/**
+			 * Gets this thread's buffer, registering it on first use.
+			 *
+			 * @return  Buffer*
+			 */
+			static Buffer* _buffer();
+
+			/**
+			 * Records an event.
+			 *
+			 * @param   const char*   name
+			 * @param   char          phase
+			 * @param   double        time
+			 * @param   double        duration or value
+			 * @return  void
+			 */
+			static void _record(const char* name, char phase, double time, double value);
+	};
+};
+
+#endif // DSTARLITE_TRACE_H
@@ -0,0 +1,539 @@
+/**
+ * Scenario benchmark.
+ *
+ * Runs full navigation episodes (see Simulation) on the bundled maps and on
+ * generated worlds, with several scan radii, and prints one CSV row per
+ * episode. The same seed always generates the same worlds and endpoints.
+ *
+ * Options go anywhere among the arguments: --queue heap|buckets picks the
+ * planner's open list and --bucket-width its bucket width, --storage
+ * dense|hash|tiled its cell state storage (see Planner::Config; tiled also
+ * splits the map into tiles), --cost double|float|fixed and --connectivity
+ * 4|8|16 the planner's cost type and grid connectivity (see BasicPlanner).
+ * --planner hierarchical runs the same episodes with the HierarchicalPlanner
+ * (--cluster-size sets its cluster width) for comparison with flat D* Lite.
+ * Every row reports the peak memory of its episode.
+ *
+ *     benchmark [options] [seed] [worlds per size] [maps directory]
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef WIN32
+	#include <windows.h>
+	#include <psapi.h>
+	#pragma comment(lib, "psapi.lib")
+#elif defined(__GLIBC__)
+	#include <malloc.h>
+#endif
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../src/bitmap.h"
+#include "../src/hierarchical_planner.h"
+#include "../src/simulation.h"
+#include "../src/timer.h"
+
+using namespace std;
+using namespace DStarLite;
+
+/**
+ * @var  unsigned int  random state
+ */
+static unsigned int seed_state;
+
+/**
+ * @var  unsigned int  scan radii of every scenario
+ */
+static const unsigned int RADII[] = { 10, 30, 50 };
+
+/**
+ * @var  unsigned int  generated world sizes
+ */
+static const unsigned int SIZES[] = { 1000, 2000 };
+
+/**
+ * @var  unsigned int  map tile width and height with tiled storage
+ */
+static const unsigned int TILE_SIZE = 64;
+
+/**
+ * Gets a repeatable random number (xorshift, same on every platform).
+ *
+ * @param   unsigned int   upper bound (exclusive)
+ * @return  unsigned int
+ */
+static unsigned int next_random(unsigned int n)
+{
+	seed_state ^= seed_state << 13;
+	seed_state ^= seed_state >> 17;
+	seed_state ^= seed_state << 5;
+
+	return seed_state % n;
+}
+
+/**
+ * Gets a percentile (nearest rank).
+ *
+ * @param   vector<double>   values (sorted)
+ * @param   double           fraction
+ * @return  double
+ */
+static double percentile(const vector<double>& values, double q)
+{
+	if (values.empty())
+		return 0;
+
+	return values[(size_t) ((values.size() - 1) * q + 0.5)];
+}
+
+/**
+ * Generates a world.
+ *
+ * Random rectangles of walls and rough terrain on open ground. The robot
+ * knows nothing at the start (its map is all open ground).
+ *
+ * @param   unsigned int            width and height
+ * @param   vector<unsigned char>&  real map
+ * @param   vector<unsigned char>&  robot map
+ * @return  void
+ */
+static void generate(unsigned int size, vector<unsigned char>& real, vector<unsigned char>& robot)
+{
+	real.assign(size * size, 255);
+	robot.assign(size * size, 255);
+
+	unsigned int rects = size * size / 2000;
+
+	for (unsigned int r = 0; r < rects; r++)
+	{
+		unsigned int x = next_random(size);
+		unsigned int y = next_random(size);
+		unsigned int w = 1 + next_random(size / 40);
+		unsigned int h = 1 + next_random(size / 40);
+
+		// Half walls, half terrain that costs 2 to 192
+		unsigned char v = (next_random(2) == 0) ? Bitmap::UNWALKABLE_CELL : (unsigned char) (64 + next_random(191));
+
+		for (unsigned int i = y; i < y + h && i < size; i++)
+		{
+			for (unsigned int j = x; j < x + w && j < size; j++)
+			{
+				real[i * size + j] = v;
+			}
+		}
+	}
+}
+
+/**
+ * Takes the options ("--name value") out of the arguments.
+ *
+ * @param   int&                   number of arguments (only the positional ones are left)
+ * @param   char**                 arguments (the positional ones are moved to the front)
+ * @param   map<string, string>&   options by name
+ * @return  bool                   successful (false if an option has no value)
+ */
+static bool parse_options(int& argc, char** argv, map<string, string>& options)
+{
+	int n = 1;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strncmp(argv[i], "--", 2) != 0)
+		{
+			argv[n++] = argv[i];
+			continue;
+		}
+
+		if (i + 1 >= argc)
+			return false;
+
+		options[argv[i] + 2] = argv[i + 1];
+		i++;
+	}
+
+	argc = n;
+
+	return true;
+}
+
+/**
+ * Applies the options to a simulation config.
+ *
+ * @param   map<string, string>&   options by name
+ * @param   Config&                config options
+ * @return  bool                   successful (false on an unknown option or value)
+ */
+template <typename P>
+static bool configure(const map<string, string>& options, typename BasicSimulation<P>::Config& config)
+{
+	typedef typename P::Config PC;
+
+	for (map<string, string>::const_iterator i = options.begin(); i != options.end(); ++i)
+	{
+		if (i->first == "bucket-width")
+		{
+			config.planner.bucket_width = atof(i->second.c_str());
+
+			if (config.planner.bucket_width <= 0)
+				return false;
+		}
+		else if (i->first == "queue" && i->second == "heap")
+		{
+			config.planner.queue = PC::QUEUE_HEAP;
+		}
+		else if (i->first == "queue" && i->second == "buckets")
+		{
+			config.planner.queue = PC::QUEUE_BUCKETS;
+		}
+		else if (i->first == "storage" && i->second == "dense")
+		{
+			config.planner.storage = PC::STORAGE_DENSE;
+		}
+		else if (i->first == "storage" && i->second == "hash")
+		{
+			config.planner.storage = PC::STORAGE_HASH;
+		}
+		else if (i->first == "storage" && i->second == "tiled")
+		{
+			// A tiled map makes the planner store its cells by tile too
+			config.planner.storage = PC::STORAGE_TILED;
+			config.tile_size = TILE_SIZE;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Applies the options to a simulation config of the hierarchical planner.
+ *
+ * @param   map<string, string>&   options by name
+ * @param   Config&                config options
+ * @return  bool                   successful (false on an unknown option or value)
+ */
+template <>
+bool configure<HierarchicalPlanner>(const map<string, string>& options, BasicSimulation<HierarchicalPlanner>::Config& config)
+{
+	for (map<string, string>::const_iterator i = options.begin(); i != options.end(); ++i)
+	{
+		if (i->first == "cluster-size")
+		{
+			config.planner.cluster_size = atoi(i->second.c_str());
+
+			if (config.planner.cluster_size < 2)
+				return false;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Gets the peak resident memory of the process.
+ *
+ * On Linux the peak is reset before every episode (see reset_peak_memory()),
+ * so it covers that episode; elsewhere it covers the run so far.
+ *
+ * @return  unsigned long   kilobytes (0 where it can't be read)
+ */
+static unsigned long peak_memory()
+{
+#ifdef WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+
+	if ( ! GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+
+	return (unsigned long) (counters.PeakWorkingSetSize / 1024);
+#else
+	FILE* fp = fopen("/proc/self/status", "r");
+
+	if (fp == NULL)
+		return 0;
+
+	char line[256];
+	unsigned long peak = 0;
+
+	while (fgets(line, sizeof(line), fp) != NULL)
+	{
+		if (sscanf(line, "VmHWM: %lu", &peak) == 1)
+			break;
+	}
+
+	fclose(fp);
+
+	return peak;
+#endif
+}
+
+/**
+ * Resets the peak resident memory of the process to the current one.
+ *
+ * Memory the last episode freed is handed back first, or the peak would
+ * start at that episode's.
+ *
+ * @return  void
+ */
+static void reset_peak_memory()
+{
+#ifdef __GLIBC__
+	malloc_trim(0);
+#endif
+
+#ifndef WIN32
+	FILE* fp = fopen("/proc/self/clear_refs", "w");
+
+	if (fp != NULL)
+	{
+		fputs("5", fp);
+		fclose(fp);
+	}
+#endif
+}
+
+/**
+ * Picks a walkable cell inside a square.
+ *
+ * @param   vector<unsigned char>&   real map
+ * @param   unsigned int             map width and height
+ * @param   unsigned int             left and top of the square
+ * @param   unsigned int             width and height of the square
+ * @return  pair<unsigned int, unsigned int>   row and column
+ */
+static pair<unsigned int, unsigned int> pick(const vector<unsigned char>& real, unsigned int size, unsigned int offset, unsigned int span)
+{
+	while (true)
+	{
+		unsigned int i = offset + next_random(span);
+		unsigned int j = offset + next_random(span);
+
+		if (real[i * size + j] != Bitmap::UNWALKABLE_CELL)
+			return pair<unsigned int, unsigned int>(i, j);
+	}
+}
+
+/**
+ * Runs one episode and prints its row.
+ *
+ * @param   char*                    scenario name
+ * @param   unsigned int             seed (0 for the bundled maps)
+ * @param   vector<unsigned char>    real map
+ * @param   vector<unsigned char>    robot map (copied, the episode updates it)
+ * @param   unsigned int             rows
+ * @param   unsigned int             columns
+ * @param   Config                   config options
+ * @return  void
+ */
+template <typename P>
+static void episode(const char* name, unsigned int seed, vector<unsigned char>& real, vector<unsigned char> robot, unsigned int rows, unsigned int cols, typename BasicSimulation<P>::Config config)
+{
+	reset_peak_memory();
+
+	Timer timer;
+
+	BasicSimulation<P> simulation(&real[0], &robot[0], rows, cols, config);
+	typename BasicSimulation<P>::Status status = simulation.run();
+
+	double total = timer.elapsed();
+
+	typename BasicSimulation<P>::Stats stats = simulation.stats();
+	sort(stats.latencies.begin(), stats.latencies.end());
+
+	double mean = stats.replans > 0 ? stats.latency_total / stats.replans : 0;
+
+	printf("%s,%u,%u,%u,%u,%s,%u,%u,%lu,%.3f,%.3f,%.4f,%.4f,%.4f,%.4f,%.3f,%lu\n",
+		name, rows, cols, config.scan_radius, seed,
+		(status == BasicSimulation<P>::STATUS_GOAL) ? "goal" : "no_path",
+		stats.steps, stats.replans, simulation.planner()->expansions(), stats.cost,
+		stats.initial * 1000, mean * 1000, percentile(stats.latencies, 0.5) * 1000, percentile(stats.latencies, 0.95) * 1000,
+		stats.latency_max * 1000, total * 1000, peak_memory());
+
+	fflush(stdout);
+}
+
+/**
+ * Runs every episode with one planner.
+ *
+ * @param   map<string, string>&   options by name (without the planner type)
+ * @param   unsigned int           seed
+ * @param   unsigned int           generated worlds per size
+ * @param   string                 maps directory
+ * @return  int                    exit code (-1 on an unknown option or value)
+ */
+template <typename P>
+static int run(const map<string, string>& options, unsigned int seed, unsigned int worlds, const string& maps)
+{
+	typename BasicSimulation<P>::Config base;
+
+	if ( ! configure<P>(options, base))
+		return -1;
+
+	printf("scenario,rows,cols,radius,seed,result,steps,replans,expansions,cost,initial_ms,replan_mean_ms,replan_p50_ms,replan_p95_ms,replan_max_ms,total_ms,peak_kb\n");
+
+	// Bundled maps, corner to corner
+	const char* names[] = { "map-01", "map-02", "map-03" };
+
+	for (unsigned int m = 0; m < 3; m++)
+	{
+		Bitmap real, robot;
+
+		if ( ! real.load((maps + "/" + names[m] + "-real.bmp").c_str()) || ! robot.load((maps + "/" + names[m] + "-robot.bmp").c_str()))
+		{
+			fprintf(stderr, "Could Not Load %s From %s!\n", names[m], maps.c_str());
+			return 1;
+		}
+
+		vector<unsigned char> real_data(real.data(), real.data() + real.w() * real.h());
+		vector<unsigned char> robot_data(robot.data(), robot.data() + robot.w() * robot.h());
+
+		for (unsigned int r = 0; r < sizeof(RADII) / sizeof(RADII[0]); r++)
+		{
+			typename BasicSimulation<P>::Config config = base;
+			config.goal = pair<unsigned int, unsigned int>(robot.h() - 1, robot.w() - 1);
+			config.scan_radius = RADII[r];
+
+			episode<P>(names[m], 0, real_data, robot_data, robot.h(), robot.w(), config);
+		}
+	}
+
+	// Generated worlds, each seeded on its own so they don't depend on the order
+	for (unsigned int s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); s++)
+	{
+		for (unsigned int w = 0; w < worlds; w++)
+		{
+			unsigned int world_seed = seed + w;
+			seed_state = world_seed * 2654435761u + SIZES[s];
+
+			if (seed_state == 0)
+			{
+				seed_state = 1;
+			}
+
+			vector<unsigned char> real, robot;
+			generate(SIZES[s], real, robot);
+
+			// Start in the top left tenth, goal in the bottom right tenth
+			typename BasicSimulation<P>::Config config = base;
+			config.start = pick(real, SIZES[s], 0, SIZES[s] / 10);
+			config.goal = pick(real, SIZES[s], SIZES[s] - SIZES[s] / 10, SIZES[s] / 10);
+
+			for (unsigned int r = 0; r < sizeof(RADII) / sizeof(RADII[0]); r++)
+			{
+				config.scan_radius = RADII[r];
+
+				episode<P>("generated", world_seed, real, robot, SIZES[s], SIZES[s], config);
+			}
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Runs every episode with the planner of a cost type and a connectivity.
+ *
+ * @param   string                 connectivity (4, 8 or 16)
+ * @param   map<string, string>&   options by name (without the planner type)
+ * @param   unsigned int           seed
+ * @param   unsigned int           generated worlds per size
+ * @param   string                 maps directory
+ * @return  int                    exit code (-1 on an unknown option or value)
+ */
+template <typename T>
+static int run_connectivity(const string& connectivity, const map<string, string>& options, unsigned int seed, unsigned int worlds, const string& maps)
+{
+	if (connectivity == "4")
+		return run<BasicPlanner<T, Neighborhood4> >(options, seed, worlds, maps);
+
+	if (connectivity == "8")
+		return run<BasicPlanner<T, Neighborhood8> >(options, seed, worlds, maps);
+
+	if (connectivity == "16")
+		return run<BasicPlanner<T, Neighborhood16> >(options, seed, worlds, maps);
+
+	return -1;
+}
+
+/**
+ * Main.
+ *
+ * @param   int      number of arguments
+ * @param   char**   arguments
+ * @return  int
+ */
+int main(int argc, char **argv)
+{
+	map<string, string> options;
+	int result = -1;
+
+	if (parse_options(argc, argv, options))
+	{
+		unsigned int seed = (argc > 1) ? atoi(argv[1]) : 1;
+		unsigned int worlds = (argc > 2) ? atoi(argv[2]) : 2;
+		string maps = (argc > 3) ? argv[3] : "maps";
+
+		if (seed == 0)
+		{
+			seed = 1;
+		}
+
+		// The planner type picks the instantiation, the rest goes into its config
+		string planner = (options.count("planner") > 0) ? options["planner"] : "dstar";
+		string cost = (options.count("cost") > 0) ? options["cost"] : "double";
+		string connectivity = (options.count("connectivity") > 0) ? options["connectivity"] : "8";
+
+		options.erase("planner");
+		options.erase("cost");
+		options.erase("connectivity");
+
+		if (planner == "hierarchical")
+		{
+			// It only plans with double costs on 8 connected grids
+			if (cost == "double" && connectivity == "8")
+			{
+				result = run<HierarchicalPlanner>(options, seed, worlds, maps);
+			}
+		}
+		else if (planner != "dstar")
+		{
+			result = -1;
+		}
+		else if (cost == "double")
+		{
+			result = run_connectivity<double>(connectivity, options, seed, worlds, maps);
+		}
+		else if (cost == "float")
+		{
+			result = run_connectivity<float>(connectivity, options, seed, worlds, maps);
+		}
+		else if (cost == "fixed")
+		{
+			result = run_connectivity<Fixed>(connectivity, options, seed, worlds, maps);
+		}
+	}
+
+	if (result < 0)
+	{
+		fprintf(stderr, "Usage: %s [--queue heap|buckets] [--bucket-width width] [--storage dense|hash|tiled] [--cost double|float|fixed] [--connectivity 4|8|16] [--planner dstar|hierarchical] [--cluster-size cells] [seed] [worlds per size] [maps directory]\n", argv[0]);
+		return 1;
+	}
+
+	return result;
+}
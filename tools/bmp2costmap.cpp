@@ -0,0 +1,88 @@
+/**
+ * Costmap converter.
+ *
+ * Converts a map bitmap to a binary costmap file (see Costmap).
+ *
+ *     bmp2costmap <bitmap> <costmap> [uint8|uint16|double]
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <string.h>
+
+#include "../src/bitmap.h"
+#include "../src/costmap.h"
+
+using namespace DStarLite;
+
+/**
+ * Main.
+ *
+ * @param   int      number of arguments
+ * @param   char**   arguments
+ * @return  int
+ */
+int main(int argc, char **argv)
+{
+	if (argc < 3)
+	{
+		printf("Usage: %s <bitmap> <costmap> [uint8|uint16|double]\n", argv[0]);
+		return 1;
+	}
+
+	// Bitmap costs are whole numbers, 8 bits hold them exactly
+	CostLayer::Format format = CostLayer::FORMAT_UINT8;
+
+	if (argc > 3)
+	{
+		if (strcmp(argv[3], "uint16") == 0)
+		{
+			format = CostLayer::FORMAT_UINT16;
+		}
+		else if (strcmp(argv[3], "double") == 0)
+		{
+			format = CostLayer::FORMAT_DOUBLE;
+		}
+		else if (strcmp(argv[3], "uint8") != 0)
+		{
+			printf("Unknown Format!\n");
+			return 1;
+		}
+	}
+
+	Bitmap bitmap;
+
+	if ( ! bitmap.load(argv[1]))
+	{
+		printf("Invalid File!\n");
+		return 1;
+	}
+
+	Map map(bitmap.h(), bitmap.w(), format);
+	bitmap.to_map(&map);
+
+	if ( ! Costmap::save(argv[2], &map, format))
+	{
+		printf("Could Not Write %s!\n", argv[2]);
+		return 1;
+	}
+
+	// Read it back the way users will
+	Map* check = Costmap::load(argv[2]);
+
+	if (check == NULL)
+	{
+		printf("Could Not Open %s!\n", argv[2]);
+		return 1;
+	}
+
+	printf("rows=%u cols=%u bytes=%lu\n", check->rows(), check->cols(), (unsigned long) check->costs()->bytes());
+
+	delete check;
+
+	return 0;
+}
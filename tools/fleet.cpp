@@ -0,0 +1,222 @@
+/**
+ * Fleet driver.
+ *
+ * Runs many agents over one shared map without a window and reports
+ * per-tick and per-agent replan latency. Built with DSTARLITE_TRACE, it
+ * writes a timeline of every thread to trace.json.
+ *
+ *     fleet <real bitmap> <robot bitmap> <agents> <scan radius> [threads] [ticks] [seed]
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/bitmap.h"
+#include "../src/fleet.h"
+#include "../src/trace.h"
+
+using namespace DStarLite;
+
+/**
+ * @var  unsigned int  random state
+ */
+static unsigned int seed_state;
+
+/**
+ * Gets a repeatable random number (xorshift, same on every platform).
+ *
+ * @param   unsigned int   upper bound (exclusive)
+ * @return  unsigned int
+ */
+static unsigned int next_random(unsigned int n)
+{
+	seed_state ^= seed_state << 13;
+	seed_state ^= seed_state >> 17;
+	seed_state ^= seed_state << 5;
+
+	return seed_state % n;
+}
+
+/**
+ * Picks a random walkable cell.
+ *
+ * @param   Map*         map
+ * @return  Map::Cell*
+ */
+static Map::Cell* random_cell(Map* map)
+{
+	while (true)
+	{
+		Map::Cell* u = (*map)(next_random(map->rows()), next_random(map->cols()));
+
+		if (map->cost(u) != Map::Cell::COST_UNWALKABLE)
+			return u;
+	}
+}
+
+/**
+ * Queues the cells an agent sees that differ from what its planner knows.
+ *
+ * @param   Fleet::Agent*   agent
+ * @param   Bitmap*         real map
+ * @param   Map*            shared map
+ * @param   unsigned int    scan radius
+ * @return  void
+ */
+static void scan(Fleet::Agent* agent, Bitmap* real, Map* map, unsigned int radius)
+{
+	Map::Cell* current = agent->planner->start();
+
+	unsigned int x = current->x();
+	unsigned int y = current->y();
+	unsigned int radius2 = radius * radius;
+
+	unsigned int max_x = (x + radius < map->cols()) ? x + radius : map->cols();
+	unsigned int max_y = (y + radius < map->rows()) ? y + radius : map->rows();
+	unsigned int min_x = (x > radius) ? x - radius : 0;
+	unsigned int min_y = (y > radius) ? y - radius : 0;
+
+	for (unsigned int i = min_y; i < max_y; i++)
+	{
+		int dy = y - i;
+
+		for (unsigned int j = min_x; j < max_x; j++)
+		{
+			int dx = x - j;
+
+			if ((unsigned int) (dx * dx + dy * dy) >= radius2)
+				continue;
+
+			Map::Cell* u = (*map)(i, j);
+			double v = Bitmap::cost(real->data()[i * map->cols() + j]);
+
+			if (agent->planner->cost(u) != v)
+			{
+				agent->changes.push_back(pair<Map::Cell*,double>(u, v));
+			}
+		}
+	}
+}
+
+/**
+ * Main.
+ *
+ * @param   int      number of arguments
+ * @param   char**   arguments
+ * @return  int
+ */
+int main(int argc, char **argv)
+{
+	if (argc < 5)
+	{
+		printf("Usage: %s <real bitmap> <robot bitmap> <agents> <scan radius> [threads] [ticks] [seed]\n", argv[0]);
+		return 1;
+	}
+
+	Bitmap real, robot;
+
+	if ( ! real.load(argv[1]) || ! robot.load(argv[2]) || real.w() != robot.w() || real.h() != robot.h())
+	{
+		printf("Invalid Files or Bitmaps Are Different Sizes!\n");
+		return 1;
+	}
+
+	unsigned int agents = atoi(argv[3]);
+	unsigned int radius = atoi(argv[4]);
+	unsigned int threads = (argc > 5) ? atoi(argv[5]) : 0;
+	unsigned int ticks = (argc > 6) ? atoi(argv[6]) : 100000;
+	seed_state = (argc > 7) ? atoi(argv[7]) : 1;
+
+	if (seed_state == 0)
+	{
+		seed_state = 1;
+	}
+
+	// Everyone shares the robot map, what they learn stays in their planners
+	Map map(robot.h(), robot.w(), CostLayer::FORMAT_UINT8);
+	robot.to_map(&map);
+
+	Fleet fleet(&map, threads);
+
+	for (unsigned int i = 0; i < agents; i++)
+	{
+		fleet.add(random_cell(&map), random_cell(&map));
+	}
+
+	vector<unsigned int> steps(agents, 0);
+
+	printf("agents=%u threads=%u\n", fleet.size(), fleet.threads());
+
+#ifdef DSTARLITE_TRACE
+	Trace::open("trace.json");
+#endif
+
+	double wall = 0;
+	double total = 0;
+	unsigned int tick;
+
+	for (tick = 0; tick < ticks; tick++)
+	{
+		unsigned int active = 0;
+
+		for (unsigned int i = 0; i < fleet.size(); i++)
+		{
+			if (fleet.agent(i)->active)
+			{
+				scan(fleet.agent(i), &real, &map, radius);
+				active++;
+			}
+		}
+
+		if (active == 0)
+			break;
+
+		Fleet::Stats stats = fleet.tick();
+		wall += stats.wall;
+		total += stats.latency_total;
+
+		printf("tick=%u agents=%u solved=%u wall_ms=%.3f mean_ms=%.3f max_ms=%.3f total_ms=%.3f\n",
+			tick, stats.agents, stats.solved, stats.wall * 1000, stats.latency_mean * 1000, stats.latency_max * 1000, stats.latency_total * 1000);
+
+		// Step every agent that has a path, the others are done
+		for (unsigned int i = 0; i < fleet.size(); i++)
+		{
+			Fleet::Agent* a = fleet.agent(i);
+			Planner* planner = a->planner;
+
+			if ( ! a->active)
+				continue;
+
+			if ( ! a->solved || planner->start() == planner->goal())
+			{
+				a->active = false;
+				continue;
+			}
+
+			planner->start(planner->next_step());
+			steps[i]++;
+		}
+	}
+
+	for (unsigned int i = 0; i < fleet.size(); i++)
+	{
+		Fleet::Agent* a = fleet.agent(i);
+
+		printf("agent=%u reached=%d steps=%u replans=%u mean_ms=%.3f max_ms=%.3f\n",
+			i, (int) (a->planner->start() == a->planner->goal()), steps[i], a->replans,
+			(a->replans > 0) ? a->latency_total * 1000 / a->replans : 0.0, a->latency_max * 1000);
+	}
+
+#ifdef DSTARLITE_TRACE
+	Trace::close();
+#endif
+
+	printf("ticks=%u wall_s=%.3f total_s=%.3f parallelism=%.2f\n", tick, wall, total, (wall > 0) ? total / wall : 0.0);
+
+	return 0;
+}
@@ -0,0 +1,656 @@
+/**
+ * Planner microbenchmarks.
+ *
+ * Times the planner's hot primitives one at a time, at several map and open
+ * list sizes, and prints one CSV row per primitive and size with ns/op
+ * statistics over repeated batches (after warm-up batches).
+ *
+ * Options go anywhere among the arguments: --cost double|float|fixed and
+ * --connectivity 4|8|16 pick the planner's cost type and grid connectivity
+ * (see BasicPlanner).
+ *
+ *     microbench [options] [repetitions] [seed]
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../src/map.h"
+#include "../src/planner.h"
+#include "../src/timer.h"
+
+using namespace std;
+using namespace DStarLite;
+
+/**
+ * Planner with its primitives made public.
+ */
+template <typename T, typename N>
+class Probe : public BasicPlanner<T,N>
+{
+	public:
+
+		Probe(Map* map, Map::Cell* start, Map::Cell* goal) : BasicPlanner<T,N>(map, start, goal) {}
+
+		using BasicPlanner<T,N>::_cost;
+		using BasicPlanner<T,N>::_g;
+		using BasicPlanner<T,N>::_h;
+		using BasicPlanner<T,N>::_k;
+		using BasicPlanner<T,N>::_list_insert;
+		using BasicPlanner<T,N>::_list_remove;
+		using BasicPlanner<T,N>::_list_update;
+		using BasicPlanner<T,N>::_min_succ;
+		using BasicPlanner<T,N>::_rhs;
+
+		/**
+		 * Gets the open list size.
+		 *
+		 * @return  unsigned int
+		 */
+		unsigned int open()
+		{
+			return this->_open_list->size();
+		}
+};
+
+/**
+ * Everything a primitive works on.
+ */
+template <typename T, typename N>
+struct Context
+{
+	/**
+	 * @var  vector<Map::Cell*>  random cells
+	 */
+	vector<Map::Cell*> cells;
+
+	/**
+	 * @var  vector<Map::Cell*>  cells outside the open list
+	 */
+	vector<Map::Cell*> fresh;
+
+	/**
+	 * @var  vector<Key>  random keys
+	 */
+	vector<typename BasicPlanner<T,N>::Key> keys;
+
+	/**
+	 * @var  vector<Map::Cell*>  random neighbors of cells
+	 */
+	vector<Map::Cell*> nbrs;
+
+	/**
+	 * @var  vector<Map::Cell*>  random cells in the open list (may repeat)
+	 */
+	vector<Map::Cell*> queued;
+
+	/**
+	 * @var  Probe*  planner
+	 */
+	Probe<T,N>* planner;
+
+	/**
+	 * @var  unsigned int  rounds so far (update alternates keys)
+	 */
+	unsigned int round;
+};
+
+/**
+ * Primitive under test.
+ */
+template <typename T, typename N>
+struct Op
+{
+	/**
+	 * @var  char*  name
+	 */
+	const char* name;
+
+	/**
+	 * @var  function  untimed work before a batch (NULL if none)
+	 */
+	void (*prepare)(Context<T,N>&);
+
+	/**
+	 * @var  function  timed batch, returns a value so nothing is optimized out
+	 */
+	double (*run)(Context<T,N>&);
+
+	/**
+	 * @var  function  untimed work after a batch (NULL if none)
+	 */
+	void (*finish)(Context<T,N>&);
+};
+
+/**
+ * @var  unsigned int  operations per batch
+ */
+static const unsigned int BATCH = 4096;
+
+/**
+ * @var  unsigned int  warm-up batches
+ */
+static const unsigned int WARMUP = 3;
+
+/**
+ * @var  unsigned int  random state
+ */
+static unsigned int seed_state;
+
+/**
+ * Gets a repeatable random number (xorshift, same on every platform).
+ *
+ * @param   unsigned int   upper bound (exclusive)
+ * @return  unsigned int
+ */
+static unsigned int next_random(unsigned int n)
+{
+	seed_state ^= seed_state << 13;
+	seed_state ^= seed_state >> 17;
+	seed_state ^= seed_state << 5;
+
+	return seed_state % n;
+}
+
+/**
+ * Queues the fresh cells.
+ *
+ * @param   Context&   context
+ * @return  void
+ */
+template <typename T, typename N>
+static void insert_fresh(Context<T,N>& c)
+{
+	for (unsigned int i = 0; i < BATCH; i++)
+	{
+		c.planner->_list_insert(c.fresh[i], c.keys[i]);
+	}
+}
+
+/**
+ * Takes the fresh cells off the open list again.
+ *
+ * @param   Context&   context
+ * @return  void
+ */
+template <typename T, typename N>
+static void remove_fresh(Context<T,N>& c)
+{
+	for (unsigned int i = 0; i < BATCH; i++)
+	{
+		c.planner->_list_remove(c.fresh[i]);
+	}
+}
+
+/**
+ * Runs a batch of _list_insert() (see insert_fresh()).
+ *
+ * @param   Context&   context
+ * @return  double   sum of the results
+ */
+template <typename T, typename N>
+static double run_insert(Context<T,N>& c)
+{
+	insert_fresh(c);
+	return c.planner->open();
+}
+
+/**
+ * Runs a batch of _list_remove() (see remove_fresh()).
+ *
+ * @param   Context&   context
+ * @return  double   sum of the results
+ */
+template <typename T, typename N>
+static double run_remove(Context<T,N>& c)
+{
+	remove_fresh(c);
+	return c.planner->open();
+}
+
+/**
+ * Runs a batch of _list_update() on queued cells.
+ *
+ * @param   Context&   context
+ * @return  double   sum of the results
+ */
+template <typename T, typename N>
+static double run_update(Context<T,N>& c)
+{
+	// Shift the keys every round so every update moves the cell
+	unsigned int shift = ++c.round;
+
+	for (unsigned int i = 0; i < BATCH; i++)
+	{
+		c.planner->_list_update(c.queued[i], c.keys[(i + shift) % BATCH]);
+	}
+
+	return c.planner->open();
+}
+
+/**
+ * Runs a batch of _g() lookups.
+ *
+ * @param   Context&   context
+ * @return  double   sum of the results
+ */
+template <typename T, typename N>
+static double run_g(Context<T,N>& c)
+{
+	double sum = 0;
+
+	for (unsigned int i = 0; i < BATCH; i++)
+	{
+		sum += (double) c.planner->_g(c.cells[i]);
+	}
+
+	return sum;
+}
+
+/**
+ * Runs a batch of _rhs() lookups.
+ *
+ * @param   Context&   context
+ * @return  double   sum of the results
+ */
+template <typename T, typename N>
+static double run_rhs(Context<T,N>& c)
+{
+	double sum = 0;
+
+	for (unsigned int i = 0; i < BATCH; i++)
+	{
+		sum += (double) c.planner->_rhs(c.cells[i]);
+	}
+
+	return sum;
+}
+
+/**
+ * Runs a batch of _min_succ().
+ *
+ * @param   Context&   context
+ * @return  double   sum of the results
+ */
+template <typename T, typename N>
+static double run_min_succ(Context<T,N>& c)
+{
+	double sum = 0;
+
+	for (unsigned int i = 0; i < BATCH; i++)
+	{
+		sum += (double) c.planner->_min_succ(c.cells[i]).second;
+	}
+
+	return sum;
+}
+
+/**
+ * Runs a batch of _k().
+ *
+ * @param   Context&   context
+ * @return  double   sum of the results
+ */
+template <typename T, typename N>
+static double run_k(Context<T,N>& c)
+{
+	double sum = 0;
+
+	for (unsigned int i = 0; i < BATCH; i++)
+	{
+		sum += Cost<T>::primary(c.planner->_k(c.cells[i]));
+	}
+
+	return sum;
+}
+
+/**
+ * Runs a batch of _cost() between neighbors.
+ *
+ * @param   Context&   context
+ * @return  double   sum of the results
+ */
+template <typename T, typename N>
+static double run_cost(Context<T,N>& c)
+{
+	double sum = 0;
+
+	for (unsigned int i = 0; i < BATCH; i++)
+	{
+		sum += (double) c.planner->_cost(c.cells[i], c.nbrs[i]);
+	}
+
+	return sum;
+}
+
+/**
+ * Runs a batch of _h() between random cells.
+ *
+ * @param   Context&   context
+ * @return  double   sum of the results
+ */
+template <typename T, typename N>
+static double run_h(Context<T,N>& c)
+{
+	double sum = 0;
+
+	for (unsigned int i = 0; i < BATCH; i++)
+	{
+		sum += (double) c.planner->_h(c.cells[i], c.fresh[i]);
+	}
+
+	return sum;
+}
+
+/**
+ * Runs a batch of one primitive and prints its row.
+ *
+ * @param   Op             primitive
+ * @param   Context&       context
+ * @param   unsigned int   map width and height
+ * @param   unsigned int   open list size
+ * @param   unsigned int   timed batches
+ * @return  double         sum of the results (keeps them alive)
+ */
+template <typename T, typename N>
+static double measure(const Op<T,N>& op, Context<T,N>& c, unsigned int size, unsigned int open, unsigned int reps)
+{
+	vector<double> ns;
+	double sink = 0;
+
+	for (unsigned int r = 0; r < WARMUP + reps; r++)
+	{
+		if (op.prepare != NULL)
+		{
+			op.prepare(c);
+		}
+
+		Timer timer;
+		sink += op.run(c);
+		double elapsed = timer.elapsed();
+
+		if (op.finish != NULL)
+		{
+			op.finish(c);
+		}
+
+		if (r >= WARMUP)
+		{
+			ns.push_back(elapsed * 1e9 / BATCH);
+		}
+	}
+
+	sort(ns.begin(), ns.end());
+
+	double mean = 0;
+	double var = 0;
+
+	for (unsigned int i = 0; i < ns.size(); i++)
+	{
+		mean += ns[i];
+	}
+
+	mean /= ns.size();
+
+	for (unsigned int i = 0; i < ns.size(); i++)
+	{
+		var += (ns[i] - mean) * (ns[i] - mean);
+	}
+
+	double stddev = (ns.size() > 1) ? sqrt(var / (ns.size() - 1)) : 0;
+
+	printf("%s,%u,%u,%.2f,%.2f,%.2f,%.2f\n", op.name, size, open, ns[ns.size() / 2], ns[0], mean, stddev);
+	fflush(stdout);
+
+	return sink;
+}
+
+/**
+ * Takes the options ("--name value") out of the arguments.
+ *
+ * @param   int&                   number of arguments (only the positional ones are left)
+ * @param   char**                 arguments (the positional ones are moved to the front)
+ * @param   map<string, string>&   options by name
+ * @return  bool                   successful (false if an option has no value)
+ */
+static bool parse_options(int& argc, char** argv, map<string, string>& options)
+{
+	int n = 1;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strncmp(argv[i], "--", 2) != 0)
+		{
+			argv[n++] = argv[i];
+			continue;
+		}
+
+		if (i + 1 >= argc)
+			return false;
+
+		options[argv[i] + 2] = argv[i + 1];
+		i++;
+	}
+
+	argc = n;
+
+	return true;
+}
+
+/**
+ * Times every primitive of one planner at every size and prints the rows.
+ *
+ * @param   unsigned int   timed batches
+ * @param   unsigned int   seed
+ * @return  double         sum of the results (keeps them alive)
+ */
+template <typename T, typename N>
+static double run(unsigned int reps, unsigned int seed)
+{
+	// Primitives under test
+	const Op<T,N> ops[] =
+	{
+		{ "list_insert", NULL, run_insert<T,N>, remove_fresh<T,N> },
+		{ "list_remove", insert_fresh<T,N>, run_remove<T,N>, NULL },
+		{ "list_update", NULL, run_update<T,N>, NULL },
+		{ "g", NULL, run_g<T,N>, NULL },
+		{ "rhs", NULL, run_rhs<T,N>, NULL },
+		{ "min_succ", NULL, run_min_succ<T,N>, NULL },
+		{ "k", NULL, run_k<T,N>, NULL },
+		{ "cost", NULL, run_cost<T,N>, NULL },
+		{ "h", NULL, run_h<T,N>, NULL }
+	};
+
+	const unsigned int sizes[] = { 128, 512, 2048 };
+	const unsigned int opens[] = { 1000, 10000, 100000 };
+
+	double sink = 0;
+
+	printf("op,map,open,ns_median,ns_min,ns_mean,ns_stddev\n");
+
+	for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+	{
+		unsigned int size = sizes[s];
+		unsigned int n = size * size;
+
+		for (unsigned int o = 0; o < sizeof(opens) / sizeof(opens[0]); o++)
+		{
+			unsigned int open = opens[o];
+
+			// The open list and the fresh cells must fit (the goal is queued too)
+			if (open + BATCH + 1 > n)
+				continue;
+
+			seed_state = (seed != 0) ? seed : 1;
+
+			// Random costs, about one cell in ten unwalkable
+			Map map(size, size);
+
+			for (unsigned int i = 0; i < size; i++)
+			{
+				for (unsigned int j = 0; j < size; j++)
+				{
+					map.cost(map(i, j), (next_random(10) == 0) ? Map::Cell::COST_UNWALKABLE : 1.0 + next_random(255));
+				}
+			}
+
+			Probe<T,N> planner(&map, map(0, 0), map(size - 1, size - 1));
+
+			// Random g and rhs values, so lookups and min_succ see real numbers
+			for (unsigned int i = 0; i < size; i++)
+			{
+				for (unsigned int j = 0; j < size; j++)
+				{
+					planner._g(map(i, j), Cost<T>::from(next_random(100000)));
+					planner._rhs(map(i, j), Cost<T>::from(next_random(100000)));
+				}
+			}
+
+			Context<T,N> c;
+			c.planner = &planner;
+			c.round = 0;
+
+			// Distinct cells in a scrambled order (the stride is odd, n is a power of 2)
+			unsigned int offset = next_random(n);
+			vector<Map::Cell*> inserted;
+
+			for (unsigned int i = 0; inserted.size() + c.fresh.size() < open + BATCH; i++)
+			{
+				unsigned int id = (unsigned int) ((offset + (unsigned long long) i * 2654435761u) % n);
+				Map::Cell* u = map(id / size, id % size);
+
+				// The goal is already queued
+				if (u == planner.goal())
+					continue;
+
+				if (inserted.size() < open)
+				{
+					planner._list_insert(u, Cost<T>::key(Cost<T>::from(next_random(1000000) / 100.0), Cost<T>::from(next_random(100000) / 100.0)));
+					inserted.push_back(u);
+				}
+				else
+				{
+					c.fresh.push_back(u);
+				}
+			}
+
+			for (unsigned int i = 0; i < BATCH; i++)
+			{
+				c.keys.push_back(Cost<T>::key(Cost<T>::from(next_random(1000000) / 100.0), Cost<T>::from(next_random(100000) / 100.0)));
+
+				Map::Cell* u = map(next_random(size), next_random(size));
+				Map::Cell* nbrs[N::SIZE];
+				unsigned int k = map.nbrs<N>(u, nbrs);
+
+				c.cells.push_back(u);
+				c.nbrs.push_back(nbrs[next_random(k)]);
+				c.queued.push_back(inserted[next_random(open)]);
+			}
+
+			for (unsigned int i = 0; i < sizeof(ops) / sizeof(ops[0]); i++)
+			{
+				sink += measure(ops[i], c, size, open, reps);
+			}
+		}
+	}
+
+	return sink;
+}
+
+/**
+ * Times every primitive of the planner of a cost type and a connectivity.
+ *
+ * @param   string         connectivity (4, 8 or 16)
+ * @param   unsigned int   timed batches
+ * @param   unsigned int   seed
+ * @param   double&        sum of the results (keeps them alive)
+ * @return  bool           successful (false on an unknown connectivity)
+ */
+template <typename T>
+static bool run_connectivity(const string& connectivity, unsigned int reps, unsigned int seed, double& sink)
+{
+	if (connectivity == "4")
+	{
+		sink = run<T, Neighborhood4>(reps, seed);
+	}
+	else if (connectivity == "8")
+	{
+		sink = run<T, Neighborhood8>(reps, seed);
+	}
+	else if (connectivity == "16")
+	{
+		sink = run<T, Neighborhood16>(reps, seed);
+	}
+	else
+	{
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Main.
+ *
+ * @param   int      number of arguments
+ * @param   char**   arguments
+ * @return  int
+ */
+int main(int argc, char **argv)
+{
+	map<string, string> options;
+
+	// Only the planner type is an option here
+	bool valid = parse_options(argc, argv, options) && options.size() == options.count("cost") + options.count("connectivity");
+
+	unsigned int reps = (argc > 1) ? atoi(argv[1]) : 15;
+	unsigned int seed = (argc > 2) ? atoi(argv[2]) : 1;
+
+	if (reps == 0)
+	{
+		reps = 1;
+	}
+
+	string cost = (options.count("cost") > 0) ? options["cost"] : "double";
+	string connectivity = (options.count("connectivity") > 0) ? options["connectivity"] : "8";
+	double sink = 0;
+
+	if (valid && cost == "double")
+	{
+		valid = run_connectivity<double>(connectivity, reps, seed, sink);
+	}
+	else if (valid && cost == "float")
+	{
+		valid = run_connectivity<float>(connectivity, reps, seed, sink);
+	}
+	else if (valid && cost == "fixed")
+	{
+		valid = run_connectivity<Fixed>(connectivity, reps, seed, sink);
+	}
+	else
+	{
+		valid = false;
+	}
+
+	if ( ! valid)
+	{
+		fprintf(stderr, "Usage: %s [--cost double|float|fixed] [--connectivity 4|8|16] [repetitions] [seed]\n", argv[0]);
+		return 1;
+	}
+
+	// Printed so the compiler can't drop the work
+	fprintf(stderr, "checksum=%g\n", sink);
+
+	return 0;
+}
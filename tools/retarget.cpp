@@ -0,0 +1,275 @@
+/**
+ * Goal move benchmark.
+ *
+ * Follows a target that wanders over a known map: every move the robot
+ * takes a few steps on its path and replans after each (so km is above 0
+ * when the goal moves), the target walks a few random cells (or jumps to a
+ * random cell without any), and the path is replanned twice, once by moving
+ * the goal of the running planner (see Planner::goal()) and once by a new
+ * planner. Prints the time and expansions of both and checks that their
+ * paths cost the same.
+ *
+ * Optionally, after every goal move a few cells on the new path (the part
+ * of the search tree the move kept) get more expensive before the paths
+ * are compared, the running planner repairs them with a replan. The map can
+ * be roughened too: every walkable cell gets a random cost up to the
+ * terrain costs, or becomes a wall.
+ *
+ *     retarget <bitmap> [moves] [target cells per move] [seed] [raised cells per move] [robot steps per move] [terrain costs]
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/bitmap.h"
+#include "../src/math.h"
+#include "../src/planner.h"
+#include "../src/timer.h"
+
+using namespace DStarLite;
+
+/**
+ * @var  unsigned int  random state
+ */
+static unsigned int seed_state;
+
+/**
+ * Gets a repeatable random number (xorshift, same on every platform).
+ *
+ * @param   unsigned int   upper bound (exclusive)
+ * @return  unsigned int
+ */
+static unsigned int next_random(unsigned int n)
+{
+	seed_state ^= seed_state << 13;
+	seed_state ^= seed_state >> 17;
+	seed_state ^= seed_state << 5;
+
+	return seed_state % n;
+}
+
+/**
+ * Picks a random walkable cell.
+ *
+ * @param   Map*         map
+ * @return  Map::Cell*
+ */
+static Map::Cell* random_cell(Map* map)
+{
+	while (true)
+	{
+		Map::Cell* u = (*map)(next_random(map->rows()), next_random(map->cols()));
+
+		if (map->cost(u) != Map::Cell::COST_UNWALKABLE)
+			return u;
+	}
+}
+
+/**
+ * Moves a cell to a random walkable neighbor.
+ *
+ * @param   Map*         map
+ * @param   Map::Cell*   cell
+ * @return  Map::Cell*   neighbor (the cell itself if it is walled in)
+ */
+static Map::Cell* wander(Map* map, Map::Cell* u)
+{
+	Map::Cell* nbrs[Neighborhood8::SIZE];
+	Map::Cell* walkable[Neighborhood8::SIZE];
+	unsigned int n = map->nbrs<Neighborhood8>(u, nbrs);
+	unsigned int m = 0;
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		if (map->cost(nbrs[i]) != Map::Cell::COST_UNWALKABLE)
+		{
+			walkable[m++] = nbrs[i];
+		}
+	}
+
+	return (m > 0) ? walkable[next_random(m)] : u;
+}
+
+/**
+ * Gets the cost of a path.
+ *
+ * @param   Map*                      map
+ * @param   list<Map::Cell*>          path
+ * @return  double                    cost (infinite without a path)
+ */
+static double path_cost(Map* map, const list<Map::Cell*>& path)
+{
+	if (path.empty())
+		return Math::INF;
+
+	double cost = 0;
+	list<Map::Cell*>::const_iterator a = path.begin();
+	list<Map::Cell*>::const_iterator b = a;
+
+	for (++b; b != path.end(); ++a, ++b)
+	{
+		double scale = ((*a)->x() != (*b)->x() && (*a)->y() != (*b)->y()) ? Math::SQRT2 : 1.0;
+		cost += scale * ((map->cost(*a) + map->cost(*b)) / 2);
+	}
+
+	return cost;
+}
+
+/**
+ * Main.
+ *
+ * @param   int      number of arguments
+ * @param   char**   arguments
+ * @return  int
+ */
+int main(int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		printf("Usage: %s <bitmap> [moves] [target cells per move] [seed] [raised cells per move] [robot steps per move] [terrain costs]\n", argv[0]);
+		return 1;
+	}
+
+	Bitmap bitmap;
+
+	if ( ! bitmap.load(argv[1]))
+	{
+		printf("Invalid File!\n");
+		return 1;
+	}
+
+	unsigned int moves = (argc > 2) ? atoi(argv[2]) : 100;
+	unsigned int hops = (argc > 3) ? atoi(argv[3]) : 3;
+	seed_state = (argc > 4) ? atoi(argv[4]) : 1;
+	unsigned int raises = (argc > 5) ? atoi(argv[5]) : 0;
+	unsigned int steps = (argc > 6) ? atoi(argv[6]) : 1;
+	unsigned int terrain = (argc > 7) ? atoi(argv[7]) : 0;
+
+	if (seed_state == 0)
+	{
+		seed_state = 1;
+	}
+
+	Map map(bitmap.h(), bitmap.w(), CostLayer::FORMAT_UINT8);
+	bitmap.to_map(&map);
+
+	// Rough terrain with rocks, the bundled maps are only open ground and walls
+	if (terrain > 0)
+	{
+		for (unsigned int i = 0; i < map.rows(); i++)
+		{
+			for (unsigned int j = 0; j < map.cols(); j++)
+			{
+				if (map.cost(map(i, j)) != Map::Cell::COST_UNWALKABLE)
+				{
+					map.cost(map(i, j), (next_random(8) == 0) ? Map::Cell::COST_UNWALKABLE : 1 + next_random(terrain));
+				}
+			}
+		}
+	}
+
+	Map::Cell* start = random_cell(&map);
+	Map::Cell* goal = random_cell(&map);
+
+	Planner planner(&map, start, goal);
+	planner.replan();
+
+	double moved_total = 0, moved_max = 0;
+	double rebuilt_total = 0, rebuilt_max = 0;
+	unsigned long moved_expansions = 0, rebuilt_expansions = 0;
+	unsigned int mismatches = 0;
+	unsigned int move;
+
+	for (move = 0; move < moves && start != goal; move++)
+	{
+		// The robot steps and replans first, so the goal moves with a km above 0
+		for (unsigned int i = 0; i < steps && start != goal; i++)
+		{
+			Map::Cell* next = planner.next_step();
+
+			if (next == NULL)
+				break;
+
+			start = next;
+			planner.start(start);
+			planner.replan();
+		}
+
+		for (unsigned int i = 0; i < hops; i++)
+		{
+			goal = wander(&map, goal);
+		}
+
+		// Without cells to walk the target jumps anywhere
+		if (hops == 0)
+		{
+			goal = random_cell(&map);
+		}
+
+		unsigned long expansions = planner.expansions();
+		Timer timer;
+
+		planner.goal(goal);
+		planner.replan();
+		double cost = path_cost(&map, planner.path());
+
+		double moved = timer.elapsed();
+		moved_expansions += planner.expansions() - expansions;
+
+		// Raise costs on the kept tree, in the map too so the new planner sees them
+		if (raises > 0 && ! planner.path().empty())
+		{
+			vector<Map::Cell*> path(planner.path().begin(), planner.path().end());
+
+			for (unsigned int i = 0; i < raises; i++)
+			{
+				Map::Cell* u = path[next_random((unsigned int) path.size())];
+
+				if (u == start || u == goal)
+					continue;
+
+				// The planner sees the old cost until its update
+				double raised = (next_random(4) == 0) ? Map::Cell::COST_UNWALKABLE : map.cost(u) + 1 + next_random(20);
+
+				planner.update(u, raised);
+				map.cost(u, raised);
+			}
+
+			planner.replan();
+			cost = path_cost(&map, planner.path());
+		}
+
+		timer.restart();
+
+		Planner fresh(&map, start, goal);
+		fresh.replan();
+		double fresh_cost = path_cost(&map, fresh.path());
+
+		double rebuilt = timer.elapsed();
+		rebuilt_expansions += fresh.expansions();
+
+		if ( ! Math::equals(cost, fresh_cost, 1e-6))
+		{
+			printf("move=%u cost=%.3f expected=%.3f\n", move, cost, fresh_cost);
+			mismatches++;
+		}
+
+		moved_total += moved;
+		rebuilt_total += rebuilt;
+		moved_max = max(moved_max, moved);
+		rebuilt_max = max(rebuilt_max, rebuilt);
+	}
+
+	printf("moves=%u mismatches=%u\n", move, mismatches);
+	printf("goal_move mean_ms=%.3f max_ms=%.3f expansions=%lu\n",
+		(move > 0) ? moved_total * 1000 / move : 0.0, moved_max * 1000, moved_expansions);
+	printf("rebuild   mean_ms=%.3f max_ms=%.3f expansions=%lu\n",
+		(move > 0) ? rebuilt_total * 1000 / move : 0.0, rebuilt_max * 1000, rebuilt_expansions);
+
+	return (mismatches == 0) ? 0 : 2;
+}
@@ -0,0 +1,177 @@
+/**
+ * Snapshot round trip check.
+ *
+ * Plans across random worlds with Anytime D*: after the first, bounded
+ * search a few random cells get cheaper and the search is repaired once,
+ * which leaves closed cells inconsistent, then it is saved (see
+ * Planner::save()) and restored into a new planner. The restored search is
+ * tightened down to a bound of 1 and its path has to cost the same as the
+ * one of a planner that searched from scratch.
+ *
+ *     roundtrip [worlds] [size] [epsilon] [lowered cells] [seed]
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/math.h"
+#include "../src/planner.h"
+
+using namespace DStarLite;
+
+/**
+ * @var  unsigned int  random state
+ */
+static unsigned int seed_state;
+
+/**
+ * Gets a repeatable random number (xorshift, same on every platform).
+ *
+ * @param   unsigned int   upper bound (exclusive)
+ * @return  unsigned int
+ */
+static unsigned int next_random(unsigned int n)
+{
+	seed_state ^= seed_state << 13;
+	seed_state ^= seed_state >> 17;
+	seed_state ^= seed_state << 5;
+
+	return seed_state % n;
+}
+
+/**
+ * Gets the cost of a path.
+ *
+ * @param   Map*                      map
+ * @param   list<Map::Cell*>          path
+ * @return  double                    cost (infinite without a path)
+ */
+static double path_cost(Map* map, const list<Map::Cell*>& path)
+{
+	if (path.empty())
+		return Math::INF;
+
+	double cost = 0;
+	list<Map::Cell*>::const_iterator a = path.begin();
+	list<Map::Cell*>::const_iterator b = a;
+
+	for (++b; b != path.end(); ++a, ++b)
+	{
+		double scale = ((*a)->x() != (*b)->x() && (*a)->y() != (*b)->y()) ? Math::SQRT2 : 1.0;
+		cost += scale * ((map->cost(*a) + map->cost(*b)) / 2);
+	}
+
+	return cost;
+}
+
+/**
+ * Main.
+ *
+ * @param   int      number of arguments
+ * @param   char**   arguments
+ * @return  int
+ */
+int main(int argc, char **argv)
+{
+	unsigned int worlds = (argc > 1) ? atoi(argv[1]) : 40;
+	unsigned int size = (argc > 2) ? atoi(argv[2]) : 60;
+	double epsilon = (argc > 3) ? atof(argv[3]) : 5;
+	unsigned int lowers = (argc > 4) ? atoi(argv[4]) : 200;
+	seed_state = (argc > 5) ? atoi(argv[5]) : 1;
+
+	if (seed_state == 0)
+	{
+		seed_state = 1;
+	}
+
+	if (size < 2 || epsilon < 1)
+	{
+		printf("Usage: %s [worlds] [size] [epsilon] [lowered cells] [seed]\n", argv[0]);
+		return 1;
+	}
+
+	const char* file = "roundtrip.snapshot";
+	unsigned int mismatches = 0;
+
+	for (unsigned int world = 0; world < worlds; world++)
+	{
+		Map map(size, size, CostLayer::FORMAT_UINT8);
+
+		for (unsigned int y = 0; y < size; y++)
+		{
+			for (unsigned int x = 0; x < size; x++)
+			{
+				map.cost(map(y, x), (next_random(8) == 0) ? Map::Cell::COST_UNWALKABLE : 1 + next_random(40));
+			}
+		}
+
+		Map::Cell* start = map(0, 0);
+		Map::Cell* goal = map(size - 1, size - 1);
+
+		map.cost(start, 1);
+		map.cost(goal, 1);
+
+		Planner::Config config;
+		config.epsilon = epsilon;
+
+		Planner planner(&map, start, goal, config);
+		planner.replan();
+
+		for (unsigned int i = 0; i < lowers; i++)
+		{
+			Map::Cell* u = map(next_random(size), next_random(size));
+
+			// The planner sees the old cost until its update
+			planner.update(u, 1);
+			map.cost(u, 1);
+		}
+
+		planner.replan();
+
+		if ( ! planner.save(file))
+		{
+			printf("Could not save %s\n", file);
+			return 1;
+		}
+
+		Planner restored(&map, start, goal);
+
+		if ( ! restored.load(file))
+		{
+			printf("world=%u not restored\n", world);
+			mismatches++;
+			continue;
+		}
+
+		bool result = true;
+
+		do
+		{
+			result = restored.replan();
+		}
+		while (result && restored.bound() > 1);
+
+		Planner fresh(&map, start, goal);
+		fresh.replan();
+
+		double cost = path_cost(&map, restored.path());
+		double expected = path_cost(&map, fresh.path());
+
+		if ( ! Math::equals(cost, expected, 1e-6))
+		{
+			printf("world=%u cost=%.3f expected=%.3f\n", world, cost, expected);
+			mismatches++;
+		}
+	}
+
+	remove(file);
+
+	printf("worlds=%u mismatches=%u\n", worlds, mismatches);
+
+	return (mismatches == 0) ? 0 : 2;
+}
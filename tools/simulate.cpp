@@ -0,0 +1,253 @@
+/**
+ * Headless simulator.
+ *
+ * Runs one scenario to the end as fast as possible and prints the result.
+ * The arguments are the simulator's, without the window name. Built with
+ * DSTARLITE_STATS, it also prints the planner's search statistics, and built
+ * with DSTARLITE_TRACE it writes a timeline to trace.json.
+ *
+ * An optional search budget in milliseconds per step suspends long replans,
+ * the robot then drives on the planner's best guess until the search is done
+ * (0 for no budget). An optional epsilon above 1 plans with Anytime D*, the
+ * path is then improved on every step until its bound is 1.
+ *
+ * Options go anywhere among the arguments: --queue heap|buckets picks the
+ * planner's open list and --bucket-width its bucket width (see
+ * Planner::Config). --planner hierarchical drives with the
+ * HierarchicalPlanner instead (--cluster-size sets its cluster width), which
+ * takes neither a budget nor an epsilon.
+ *
+ *     simulate [options] <real bitmap> <robot bitmap> <start x> <start y> <goal x> <goal y> <scan radius> [budget ms] [epsilon]
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <string>
+
+#include "../src/bitmap.h"
+#include "../src/hierarchical_planner.h"
+#include "../src/simulation.h"
+#include "../src/trace.h"
+
+using namespace std;
+using namespace DStarLite;
+
+/**
+ * Takes the options ("--name value") out of the arguments.
+ *
+ * @param   int&                   number of arguments (only the positional ones are left)
+ * @param   char**                 arguments (the positional ones are moved to the front)
+ * @param   map<string, string>&   options by name
+ * @return  bool                   successful (false if an option has no value)
+ */
+static bool parse_options(int& argc, char** argv, map<string, string>& options)
+{
+	int n = 1;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strncmp(argv[i], "--", 2) != 0)
+		{
+			argv[n++] = argv[i];
+			continue;
+		}
+
+		if (i + 1 >= argc)
+			return false;
+
+		options[argv[i] + 2] = argv[i + 1];
+		i++;
+	}
+
+	argc = n;
+
+	return true;
+}
+
+/**
+ * Applies the options to a planner config.
+ *
+ * @param   map<string, string>&   options by name
+ * @param   Planner::Config&       planner config options
+ * @return  bool                   successful (false on an unknown option or value)
+ */
+static bool configure(const map<string, string>& options, Planner::Config& config)
+{
+	for (map<string, string>::const_iterator i = options.begin(); i != options.end(); ++i)
+	{
+		if (i->first == "bucket-width")
+		{
+			config.bucket_width = atof(i->second.c_str());
+
+			if (config.bucket_width <= 0)
+				return false;
+		}
+		else if (i->first == "queue" && i->second == "heap")
+		{
+			config.queue = Planner::Config::QUEUE_HEAP;
+		}
+		else if (i->first == "queue" && i->second == "buckets")
+		{
+			config.queue = Planner::Config::QUEUE_BUCKETS;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Applies the options to a hierarchical planner config.
+ *
+ * @param   map<string, string>&           options by name
+ * @param   HierarchicalPlanner::Config&   planner config options
+ * @return  bool                           successful (false on an unknown option or value)
+ */
+static bool configure(const map<string, string>& options, HierarchicalPlanner::Config& config)
+{
+	for (map<string, string>::const_iterator i = options.begin(); i != options.end(); ++i)
+	{
+		if (i->first == "cluster-size")
+		{
+			config.cluster_size = atoi(i->second.c_str());
+
+			if (config.cluster_size < 2)
+				return false;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Prints the end of the result line and the search statistics.
+ *
+ * @param   Planner*   planner
+ * @return  void
+ */
+static void report(Planner* planner)
+{
+	printf(" bound=%.2f\n", planner->bound());
+
+#ifdef DSTARLITE_STATS
+	Planner::Stats search = planner->stats_total();
+
+	printf("expansions_over=%lu expansions_under=%lu inserts=%lu updates=%lu removes=%lu open_peak=%lu min_succ=%lu cells=%lu compute_ms=%.3f path_ms=%.3f\n",
+		search.expansions_over, search.expansions_under, search.inserts, search.updates, search.removes, search.open_peak,
+		search.min_succ, search.cells, search.compute_time * 1000, search.path_time * 1000);
+#endif
+}
+
+/**
+ * Prints the end of the result line (the paths have no bound).
+ *
+ * @param   HierarchicalPlanner*   planner
+ * @return  void
+ */
+static void report(HierarchicalPlanner* planner)
+{
+	printf(" expansions=%lu\n", planner->expansions());
+}
+
+/**
+ * Runs the scenario and prints the result.
+ *
+ * @param   char**     arguments (positional only)
+ * @param   Config     config options (planner options applied)
+ * @return  int        exit code
+ */
+template <typename P>
+static int simulate(char** argv, typename BasicSimulation<P>::Config config)
+{
+	typedef BasicSimulation<P> S;
+
+	Bitmap real, robot;
+
+	if ( ! real.load(argv[1]) || ! robot.load(argv[2]) || real.w() != robot.w() || real.h() != robot.h())
+	{
+		printf("Invalid Files or Bitmaps Are Different Sizes!\n");
+		return 1;
+	}
+
+	config.start.first = atoi(argv[3]);
+	config.start.second = atoi(argv[4]);
+	config.goal.first = atoi(argv[5]);
+	config.goal.second = atoi(argv[6]);
+	config.scan_radius = atoi(argv[7]);
+
+	if (config.start.first >= robot.h() || config.start.second >= robot.w() || config.goal.first >= robot.h() || config.goal.second >= robot.w())
+	{
+		printf("Start or Goal Outside the Map!\n");
+		return 1;
+	}
+
+#ifdef DSTARLITE_TRACE
+	Trace::open("trace.json");
+#endif
+
+	S simulation(real.data(), robot.data(), robot.h(), robot.w(), config);
+	typename S::Status status = simulation.run();
+	typename S::Stats stats = simulation.stats();
+
+#ifdef DSTARLITE_TRACE
+	Trace::close();
+#endif
+
+	printf("result=%s steps=%u replans=%u cost=%.3f initial_ms=%.3f replan_max_ms=%.3f replan_total_ms=%.3f wall_ms=%.3f interim=%u",
+		(status == S::STATUS_GOAL) ? "goal" : "no_path", stats.steps, stats.replans, stats.cost,
+		stats.initial * 1000, stats.latency_max * 1000, stats.latency_total * 1000, stats.wall * 1000, stats.interim);
+
+	report(simulation.planner());
+
+	return (status == S::STATUS_GOAL) ? 0 : 2;
+}
+
+/**
+ * Main.
+ *
+ * @param   int      number of arguments
+ * @param   char**   arguments
+ * @return  int
+ */
+int main(int argc, char **argv)
+{
+	map<string, string> options;
+	bool parsed = parse_options(argc, argv, options);
+
+	string planner = (options.count("planner") > 0) ? options["planner"] : "dstar";
+	options.erase("planner");
+
+	if (parsed && argc >= 8 && planner == "hierarchical")
+	{
+		BasicSimulation<HierarchicalPlanner>::Config config;
+
+		if (configure(options, config.planner) && argc == 8)
+			return simulate<HierarchicalPlanner>(argv, config);
+	}
+	else if (parsed && argc >= 8 && argc <= 10 && planner == "dstar")
+	{
+		Simulation::Config config;
+		config.planner.budget_time = (argc > 8) ? atof(argv[8]) / 1000 : 0;
+		config.planner.epsilon = (argc > 9) ? atof(argv[9]) : 1;
+
+		if (configure(options, config.planner))
+			return simulate<Planner>(argv, config);
+	}
+
+	printf("Usage: %s [--queue heap|buckets] [--bucket-width width] [--planner dstar|hierarchical] [--cluster-size cells] <real bitmap> <robot bitmap> <start x> <start y> <goal x> <goal y> <scan radius> [budget ms] [epsilon]\n", argv[0]);
+	return 1;
+}
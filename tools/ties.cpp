@@ -0,0 +1,181 @@
+/**
+ * Key tie check.
+ *
+ * Drives a robot across random worlds of open ground with rectangles of
+ * walls and rough terrain that it only learns by scanning around itself.
+ * On open ground the octile heuristic is exact, so the first keys of the
+ * cells on the path tie the start's and differ only by round-off. After
+ * every replan the path has to reach the goal and cost the same as the one
+ * of a planner that searched the robot's map from scratch.
+ *
+ *     ties [worlds] [size] [scan radius] [seed]
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "../src/math.h"
+#include "../src/planner.h"
+
+using namespace DStarLite;
+
+/**
+ * @var  unsigned int  random state
+ */
+static unsigned int seed_state;
+
+/**
+ * Gets a repeatable random number (xorshift, same on every platform).
+ *
+ * @param   unsigned int   upper bound (exclusive)
+ * @return  unsigned int
+ */
+static unsigned int next_random(unsigned int n)
+{
+	seed_state ^= seed_state << 13;
+	seed_state ^= seed_state >> 17;
+	seed_state ^= seed_state << 5;
+
+	return seed_state % n;
+}
+
+/**
+ * Gets the cost of a path.
+ *
+ * @param   Map*                      map
+ * @param   list<Map::Cell*>          path
+ * @return  double                    cost (infinite without a path)
+ */
+static double path_cost(Map* map, const list<Map::Cell*>& path)
+{
+	if (path.empty())
+		return Math::INF;
+
+	double cost = 0;
+	list<Map::Cell*>::const_iterator a = path.begin();
+	list<Map::Cell*>::const_iterator b = a;
+
+	for (++b; b != path.end(); ++a, ++b)
+	{
+		double scale = ((*a)->x() != (*b)->x() && (*a)->y() != (*b)->y()) ? Math::SQRT2 : 1.0;
+		cost += scale * ((map->cost(*a) + map->cost(*b)) / 2);
+	}
+
+	return cost;
+}
+
+/**
+ * Main.
+ *
+ * @param   int      number of arguments
+ * @param   char**   arguments
+ * @return  int
+ */
+int main(int argc, char **argv)
+{
+	unsigned int worlds = (argc > 1) ? atoi(argv[1]) : 20;
+	unsigned int size = (argc > 2) ? atoi(argv[2]) : 200;
+	unsigned int radius = (argc > 3) ? atoi(argv[3]) : 20;
+	seed_state = (argc > 4) ? atoi(argv[4]) : 1;
+
+	if (seed_state == 0)
+	{
+		seed_state = 1;
+	}
+
+	if (size < 2)
+	{
+		printf("Usage: %s [worlds] [size] [scan radius] [seed]\n", argv[0]);
+		return 1;
+	}
+
+	unsigned int mismatches = 0;
+	unsigned int replans = 0;
+
+	for (unsigned int world = 0; world < worlds; world++)
+	{
+		// Half walls, half terrain that costs 2 to 40
+		vector<double> real(size * size, 1);
+		unsigned int rects = size * size / 500;
+
+		for (unsigned int r = 0; r < rects; r++)
+		{
+			unsigned int x = next_random(size);
+			unsigned int y = next_random(size);
+			unsigned int w = 1 + next_random(size / 20);
+			unsigned int h = 1 + next_random(size / 20);
+			double cost = (next_random(2) == 0) ? Map::Cell::COST_UNWALKABLE : 2 + next_random(39);
+
+			for (unsigned int i = y; i < y + h && i < size; i++)
+			{
+				for (unsigned int j = x; j < x + w && j < size; j++)
+				{
+					real[i * size + j] = cost;
+				}
+			}
+		}
+
+		real[0] = 1;
+		real[size * size - 1] = 1;
+
+		// The robot knows nothing, its map is all open ground
+		Map map(size, size, CostLayer::FORMAT_UINT8);
+		Map::Cell* start = map(0, 0);
+		Map::Cell* goal = map(size - 1, size - 1);
+
+		Planner planner(&map, start, goal);
+		bool result = planner.replan();
+
+		while (result && start != goal)
+		{
+			// Scan around the robot
+			for (unsigned int i = (start->y() > radius) ? start->y() - radius : 0; i <= start->y() + radius && i < size; i++)
+			{
+				for (unsigned int j = (start->x() > radius) ? start->x() - radius : 0; j <= start->x() + radius && j < size; j++)
+				{
+					Map::Cell* u = map(i, j);
+
+					// The planner sees the old cost until its update
+					if (map.cost(u) != real[i * size + j])
+					{
+						planner.update(u, real[i * size + j]);
+						map.cost(u, real[i * size + j]);
+					}
+				}
+			}
+
+			result = planner.replan();
+			replans++;
+
+			Planner fresh(&map, start, goal);
+			bool expected = fresh.replan();
+
+			double cost = result ? path_cost(&map, planner.path()) : Math::INF;
+			double expected_cost = expected ? path_cost(&map, fresh.path()) : Math::INF;
+
+			if (result != expected || ! Math::equals(cost, expected_cost, 1e-6))
+			{
+				printf("world=%u x=%u y=%u cost=%.3f expected=%.3f\n", world, start->x(), start->y(), cost, expected_cost);
+				mismatches++;
+				break;
+			}
+
+			if ( ! result)
+				break;
+
+			list<Map::Cell*>::const_iterator next = planner.path().begin();
+			start = *(++next);
+			planner.start(start);
+		}
+	}
+
+	printf("worlds=%u replans=%u mismatches=%u\n", worlds, replans, mismatches);
+
+	return (mismatches == 0) ? 0 : 2;
+}
@@ -0,0 +1,153 @@
+/**
+ * Warm start.
+ *
+ * Plans between two cells of a known map the way a restarted process
+ * would: the search is restored from a snapshot when there is one for this
+ * map (see Planner::load()), otherwise it runs from scratch and is saved
+ * for the next run. Prints the time and expansions either way.
+ *
+ * A restored search is moved to the given start and goal if the snapshot
+ * was saved with others. With an epsilon above 1 the snapshot is saved
+ * while the search is still bounded; a warm run tightens the restored one
+ * down to a bound of 1 and checks its path against a new planner's.
+ *
+ *     warmstart <bitmap> <snapshot> <start x> <start y> <goal x> <goal y> [epsilon]
+ *
+ * @package		DStarLite
+ * @author		Aaron Zampaglione <azampagl@gmail.com>
+ * @copyright	Copyright (C) 2011 Aaron Zampaglione
+ * @license		MIT
+ */
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/bitmap.h"
+#include "../src/math.h"
+#include "../src/planner.h"
+#include "../src/timer.h"
+
+using namespace DStarLite;
+
+/**
+ * Gets the cost of a path.
+ *
+ * @param   Map*                      map
+ * @param   list<Map::Cell*>          path
+ * @return  double                    cost (infinite without a path)
+ */
+static double path_cost(Map* map, const list<Map::Cell*>& path)
+{
+	if (path.empty())
+		return Math::INF;
+
+	double cost = 0;
+	list<Map::Cell*>::const_iterator a = path.begin();
+	list<Map::Cell*>::const_iterator b = a;
+
+	for (++b; b != path.end(); ++a, ++b)
+	{
+		double scale = ((*a)->x() != (*b)->x() && (*a)->y() != (*b)->y()) ? Math::SQRT2 : 1.0;
+		cost += scale * ((map->cost(*a) + map->cost(*b)) / 2);
+	}
+
+	return cost;
+}
+
+/**
+ * Main.
+ *
+ * @param   int      number of arguments
+ * @param   char**   arguments
+ * @return  int
+ */
+int main(int argc, char **argv)
+{
+	if (argc < 7)
+	{
+		printf("Usage: %s <bitmap> <snapshot> <start x> <start y> <goal x> <goal y> [epsilon]\n", argv[0]);
+		return 1;
+	}
+
+	Bitmap bitmap;
+
+	if ( ! bitmap.load(argv[1]))
+	{
+		printf("Invalid File!\n");
+		return 1;
+	}
+
+	Map map(bitmap.h(), bitmap.w(), CostLayer::FORMAT_UINT8);
+	bitmap.to_map(&map);
+
+	unsigned int x[2], y[2];
+
+	for (unsigned int i = 0; i < 2; i++)
+	{
+		x[i] = atoi(argv[3 + 2 * i]);
+		y[i] = atoi(argv[4 + 2 * i]);
+
+		if ( ! map.has(y[i], x[i]))
+		{
+			printf("Invalid Cell!\n");
+			return 1;
+		}
+	}
+
+	Map::Cell* start = map(y[0], x[0]);
+	Map::Cell* goal = map(y[1], x[1]);
+
+	Planner::Config config;
+	config.epsilon = (argc > 7) ? atof(argv[7]) : 1;
+
+	Planner planner(&map, start, goal, config);
+	Timer timer;
+
+	bool warm = planner.load(argv[2]);
+
+	// The snapshot brings its own start and goal, the ones asked for win
+	if (warm && planner.goal() != goal)
+	{
+		planner.goal(goal);
+	}
+
+	if (warm && planner.start() != start)
+	{
+		planner.start(start);
+	}
+
+	double loaded = timer.elapsed();
+
+	timer.restart();
+	bool result = planner.replan();
+	double planned = timer.elapsed();
+
+	printf("%s load_ms=%.3f replan_ms=%.3f expansions=%lu result=%s length=%u bound=%.2f\n",
+		warm ? "warm" : "cold", loaded * 1000, planned * 1000, planner.expansions(),
+		result ? "path" : "none", (unsigned int) planner.path().size(), planner.bound());
+
+	if ( ! warm && ! planner.save(argv[2]))
+	{
+		printf("Could not save %s\n", argv[2]);
+		return 1;
+	}
+
+	if ( ! warm)
+		return result ? 0 : 2;
+
+	// The restored search has to end up as good as a new one
+	while (result && planner.bound() > 1)
+	{
+		result = planner.replan();
+	}
+
+	Planner fresh(&map, start, goal);
+	fresh.replan();
+
+	double cost = path_cost(&map, planner.path());
+	double expected = path_cost(&map, fresh.path());
+
+	printf("cost=%.3f expected=%.3f\n", cost, expected);
+
+	return (result && Math::equals(cost, expected, 1e-6)) ? 0 : 2;
+}